@@ -5,20 +5,57 @@
 #include "rng.h"
 #include "skiplist.h"
 
+// Nombre de recherches menées de front par skiplist_search_batch
+#define TAILLE_GROUPE 8
+// Nombre maximal de noeuds supprimés gardés pour être réutilisés
+#define RECYCLAGE_MAX 1024
+// Nombre de noeuds déplacés par le compactage progressif à chaque insertion ou suppression
+#define PAS_COMPACTAGE 8
+// Place réservée par chaque bloc du compactage progressif
+#define TAILLE_TRONCON 65536
+
+#ifdef __GNUC__
+#define PRECHARGER(adresse) __builtin_prefetch(adresse)
+#else
+#define PRECHARGER(adresse) ((void)(adresse))
+#endif
+
+typedef struct s_bloc* Bloc;
+struct s_bloc {
+    size_t nb_noeuds;       // Le nombre de noeuds encore vivants dans le bloc, qui les suit
+};
+
 typedef struct s_node* Noeud;
 struct s_node {
     Noeud* suivants;        // Les noeuds suivants
     Noeud* precedents;      // Les noeuds précédents
+    long long* sommes;      // Pour chaque niveau, la somme des valeurs des noeuds atteints par le lien vers le suivant
+    unsigned int* largeurs; // Pour chaque niveau, le nombre de noeuds atteints par le lien vers le suivant
+    Bloc bloc;              // Le bloc contenant le noeud, NULL s'il a été alloué seul
     unsigned int hauteur;   // La hauteur du noeud
     int valeur;             // La valeur du noeud
+    Noeud liens[];          // Les tableaux du noeud, à la suite du noeud
 };
 
 struct s_SkipList {
     Noeud* premiers;             // Les premiers noeuds de la liste
     Noeud* derniers;             // Les derniers noeuds de la liste
+    long long* sommes_premiers;  // La somme des valeurs jusqu'aux premiers noeuds (de toute la liste si le niveau est vide)
+    unsigned int* largeurs_premiers; // Le rang des premiers noeuds (la taille de la liste si le niveau est vide)
     RNG rngesus;                 // Générateur de nombre aléatoire
     unsigned int hauteur;        // La hauteur maximale de la liste
     unsigned int nb_elements;    // Le nombre de noeuds dans la liste
+    Noeud* chemin;               // Le vecteur de mise à jour rempli par descendre
+    unsigned int* rangs;         // Le rang de chaque noeud du vecteur de mise à jour
+    long long* prefixes;         // La somme des valeurs jusqu'à chaque noeud du vecteur de mise à jour
+    unsigned int nb_mutations;   // Le nombre d'insertions et de suppressions depuis le dernier compactage
+    unsigned int seuil;          // Le nombre de mutations déclenchant un compactage, 0 si jamais
+    Noeud a_compacter;           // Le prochain noeud à déplacer par le compactage progressif, NULL s'il n'y en a pas en cours
+    Bloc bloc_ouvert;            // Le bloc que remplit le compactage progressif, NULL s'il n'y en a pas
+    char* place;                 // La première place libre du bloc ouvert
+    size_t place_restante;       // Le nombre d'octets encore libres dans le bloc ouvert
+    Noeud* recycles;             // Pour chaque hauteur, les noeuds supprimés à réutiliser, chaînés par suivants[0]
+    unsigned int nb_recycles;    // Le nombre de noeuds à réutiliser
 };
 
 struct s_SkipListIterator {
@@ -39,27 +76,99 @@ SkipList skiplist_create(int nb_levels) {
     assert(sk->premiers != NULL);
     sk->derniers = (Noeud*)malloc(sizeof(Noeud)*nb_levels);
     assert(sk->derniers != NULL);
+    sk->sommes_premiers = (long long*)malloc(sizeof(long long)*nb_levels);
+    assert(sk->sommes_premiers != NULL);
+    sk->largeurs_premiers = (unsigned int*)malloc(sizeof(unsigned int)*nb_levels);
+    assert(sk->largeurs_premiers != NULL);
     for (int i = 0; i < nb_levels; i++) {
         sk->premiers[i] = NULL;
         sk->derniers[i] = NULL;
+        sk->sommes_premiers[i] = 0;
+        sk->largeurs_premiers[i] = 0;
     }
+    // Initialise le vecteur de mise à jour
+    sk->chemin = (Noeud*)malloc(sizeof(Noeud)*nb_levels);
+    assert(sk->chemin != NULL);
+    sk->rangs = (unsigned int*)malloc(sizeof(unsigned int)*nb_levels);
+    assert(sk->rangs != NULL);
+    sk->prefixes = (long long*)malloc(sizeof(long long)*nb_levels);
+    assert(sk->prefixes != NULL);
     // Initialise la hauteur de la liste et le nombre d'éléments
     sk->hauteur = (unsigned int)nb_levels;
     sk->nb_elements = 0;
+    // Initialise le compactage
+    sk->nb_mutations = 0;
+    sk->seuil = 0;
+    sk->a_compacter = NULL;
+    sk->bloc_ouvert = NULL;
+    sk->place = NULL;
+    sk->place_restante = 0;
+    // Initialise le recyclage des noeuds
+    sk->recycles = (Noeud*)malloc(sizeof(Noeud)*nb_levels);
+    assert(sk->recycles != NULL);
+    for (int i = 0; i < nb_levels; i++)
+        sk->recycles[i] = NULL;
+    sk->nb_recycles = 0;
     return sk;
 }
 
+/**
+ * \brief Calcule la place occupée en mémoire par un noeud et ses tableaux de liens
+ * \param hauteur La hauteur du noeud
+ * \return La taille du noeud en octets
+ */
+size_t taille_noeud(unsigned int hauteur) {
+    size_t taille = sizeof(struct s_node) + 2*hauteur*sizeof(Noeud) + hauteur*(sizeof(long long) + sizeof(unsigned int));
+    // Arrondit la taille pour que les noeuds compactés restent alignés
+    return (taille + sizeof(long long) - 1) / sizeof(long long) * sizeof(long long);
+}
+
+/**
+ * \brief Place les tableaux de noeuds suivants et précédents, de sommes et de largeurs à la suite du noeud
+ * \param nd Le noeud dont la hauteur est initialisée
+ */
+void lier_tableaux(Noeud nd) {
+    nd->suivants = nd->liens;
+    nd->precedents = nd->liens + nd->hauteur;
+    nd->sommes = (long long*)(nd->liens + 2*nd->hauteur);
+    nd->largeurs = (unsigned int*)(nd->sommes + nd->hauteur);
+}
+
+/**
+ * \brief Accède aux largeurs des liens partant d'un noeud
+ * \param d La liste du noeud
+ * \param nd Le noeud, NULL pour le début de la liste
+ */
+unsigned int* largeurs_de(SkipList d, Noeud nd) {
+    return (nd == NULL) ? d->largeurs_premiers : nd->largeurs;
+}
+
+/**
+ * \brief Accède aux sommes des liens partant d'un noeud
+ * \param d La liste du noeud
+ * \param nd Le noeud, NULL pour le début de la liste
+ */
+long long* sommes_de(SkipList d, Noeud nd) {
+    return (nd == NULL) ? d->sommes_premiers : nd->sommes;
+}
+
 Noeud creer_noeud(SkipList d, int x) {
-    // Alloue en mémoire un noeud
-    Noeud nd = (Noeud)malloc(sizeof(struct s_node));
-    assert(nd != NULL);
     // Génère la hauteur du noeud
-    nd->hauteur = (int)rng_get_value(&d->rngesus, d->hauteur-1)+1;
+    unsigned int hauteur = rng_get_value(&d->rngesus, d->hauteur-1)+1;
+    Noeud nd = d->recycles[hauteur-1];
+    if (nd != NULL) {
+        // Réutilise un noeud supprimé de la même hauteur
+        d->recycles[hauteur-1] = nd->suivants[0];
+        d->nb_recycles--;
+    } else {
+        // Alloue en mémoire un noeud et ses tableaux de noeuds suivants et précédents
+        nd = (Noeud)malloc(taille_noeud(hauteur));
+        assert(nd != NULL);
+        nd->hauteur = hauteur;
+        nd->bloc = NULL;
+    }
     // Initialise les tableaux de noeuds suivants et précédents
-    nd->suivants = (Noeud*)malloc(sizeof(Noeud)*nd->hauteur);
-    assert(nd->suivants != NULL);
-    nd->precedents = (Noeud*)malloc(sizeof(Noeud)*nd->hauteur);
-    assert(nd->precedents != NULL);
+    lier_tableaux(nd);
     for (int i = 0; i < (int)nd->hauteur; i++) {
         nd->suivants[i] = NULL;
         nd->precedents[i] = NULL;
@@ -72,14 +181,45 @@ Noeud creer_noeud(SkipList d, int x) {
 /**
  * \brief Détruit un noeud
  * \param nd Noeud à détruire
+ * \note Un noeud rangé dans un bloc par skiplist_compact n'est libéré qu'avec le dernier noeud du bloc
  */
 void detruire_noeud(Noeud nd) {
-    free(nd->suivants);
-    free(nd->precedents);
-    free(nd);
+    if (nd->bloc == NULL)
+        free(nd);
+    else if (--nd->bloc->nb_noeuds == 0)
+        free(nd->bloc);
+}
+
+/**
+ * \brief Garde un noeud supprimé de la liste pour le réutiliser, ou le détruit s'il y en a déjà assez
+ * \param d La liste dont le noeud a été supprimé
+ * \param nd Noeud à recycler
+ * \note Un noeud rangé dans un bloc est détruit : gardé, il retiendrait tout son bloc en mémoire
+ */
+void recycler_noeud(SkipList d, Noeud nd) {
+    if (nd->bloc != NULL || d->nb_recycles == RECYCLAGE_MAX) {
+        detruire_noeud(nd);
+        return;
+    }
+    nd->suivants[0] = d->recycles[nd->hauteur-1];
+    d->recycles[nd->hauteur-1] = nd;
+    d->nb_recycles++;
+}
+
+/**
+ * \brief Arrête le compactage progressif, le bloc ouvert étant libéré avec son dernier noeud
+ * \param d La liste compactée
+ */
+void terminer_compactage(SkipList d) {
+    d->a_compacter = NULL;
+    if (d->bloc_ouvert != NULL && --d->bloc_ouvert->nb_noeuds == 0)
+        free(d->bloc_ouvert);
+    d->bloc_ouvert = NULL;
+    d->place_restante = 0;
 }
 
 void skiplist_delete(SkipList d) {
+    terminer_compactage(d);
     // Place le noeud courant sur le premier noeud de la liste
     Noeud courant = d->premiers[0];
     Noeud precedent = NULL;
@@ -90,9 +230,23 @@ void skiplist_delete(SkipList d) {
         // Détruit le noeud précédent
         detruire_noeud(precedent);
     }
+    // Détruit les noeuds à réutiliser
+    for (unsigned int i = 0; i < d->hauteur; i++) {
+        while (d->recycles[i] != NULL) {
+            precedent = d->recycles[i];
+            d->recycles[i] = precedent->suivants[0];
+            detruire_noeud(precedent);
+        }
+    }
+    free(d->recycles);
     // Libère en mémoire les tableaux de premiers et derniers noeuds
     free(d->premiers);
     free(d->derniers);
+    free(d->sommes_premiers);
+    free(d->largeurs_premiers);
+    free(d->chemin);
+    free(d->rangs);
+    free(d->prefixes);
     // Libère en mémoire la skiplist
     free(d);
 }
@@ -101,14 +255,33 @@ unsigned int skiplist_size(SkipList d) {
     return d->nb_elements;
 }
 
+/**
+ * \brief Descend dans la liste jusqu'au noeud d'un rang donné en suivant les largeurs des liens
+ * \param d La liste dans laquelle on descend
+ * \param rang Le rang du noeud, à partir de 1
+ * \return Le noeud de ce rang
+ */
+Noeud noeud_de_rang(SkipList d, unsigned int rang) {
+    assert(rang >= 1 && rang <= d->nb_elements);
+    Noeud courant = NULL;
+    Noeud* suivants = d->premiers;
+    unsigned int* largeurs = d->largeurs_premiers;
+    unsigned int r = 0;
+    for (int i = (int)d->hauteur-1; i >= 0 && r != rang; i--) {
+        // Avance sur le niveau tant que le rang n'est pas dépassé
+        while (suivants[i] != NULL && r + largeurs[i] <= rang) {
+            r += largeurs[i];
+            courant = suivants[i];
+            suivants = courant->suivants;
+            largeurs = courant->largeurs;
+        }
+    }
+    return courant;
+}
+
 int skiplist_ith(SkipList d, unsigned int i) {
     assert(i < d->nb_elements);
-    // Place le noeud courant sur le premier noeud
-    Noeud courant = d->premiers[0];
-    // Avance le noeud courant jusqu'au ième noeud
-    for (unsigned int j = 0; j != i; j++)
-        courant = courant->suivants[0];
-    return courant->valeur;
+    return noeud_de_rang(d, i+1)->valeur;
 }
 
 void skiplist_map(SkipList d, ScanOperator f, void *user_data) {
@@ -137,85 +310,438 @@ int noeud_haut(Noeud* des_noeuds, Noeud* nd, int max) {
     return max;
 }
 
-SkipList skiplist_insert(SkipList d, int value) {
-    // Initialise le noeud courant
-    Noeud courant = NULL;
-    // ainsi que les tableaux de noeuds suivants et précédents
-    Noeud suivants[d->hauteur];
-    Noeud precedents[d->hauteur];
+void skiplist_compact(SkipList d) {
+    terminer_compactage(d);
+    if (d->nb_elements == 0)
+        return;
+    // Calcule la place occupée par les noeuds
+    size_t taille = sizeof(struct s_bloc);
+    for (Noeud courant = d->premiers[0]; courant != NULL; courant = courant->suivants[0])
+        taille += taille_noeud(courant->hauteur);
+    Bloc bloc = (Bloc)malloc(taille);
+    assert(bloc != NULL);
+    bloc->nb_noeuds = d->nb_elements;
+    // Vide la liste, les derniers noeuds servant à reconstruire les tours
+    Noeud courant = d->premiers[0];
     for (unsigned int i = 0; i < d->hauteur; i++) {
-        suivants[i] = d->premiers[i];
-        precedents[i] = NULL;
-    }
-    // Récupère le premier noeud non null et la hauteur a laquelle il a été trouvée
-    int max = noeud_haut(suivants, &courant, d->hauteur-1);
-    while (max >= 0 && courant != NULL) {
-        if (courant->valeur > value) {
-            // Le noeud courant est trop grand
-            max--;
-            // Le prochain noeud est celui en dessous
-            if (max >= 0)
-                courant = suivants[max];
-        } else if (courant->valeur < value) {
-            // Le noeud courant est plus petit
-            max = courant->hauteur-1;
-            // Mise à jour des noeuds précédents et suivants
-            for (int i = 0; i < value && i < (int)courant->hauteur; i++)
-                precedents[i] = courant;
-            for (unsigned int j = 0; j < courant->hauteur; j++)
-                suivants[j] = courant->suivants[j];
-            // Récupère le premier noeud non null et la hauteur a laquelle il a été trouvée
-            max = noeud_haut(suivants, &courant, max);
-        } else
-            // Un noeud de cette valeur existe déjà
-            courant = NULL;
-    }
-    if (max < 0) {
-        // Crée le noeud à insérer
-        Noeud nouveau = creer_noeud(d, value);
-        // Initialise ses noeuds suivants et précédents
+        d->premiers[i] = NULL;
+        d->derniers[i] = NULL;
+        d->rangs[i] = 0;
+        d->prefixes[i] = 0;
+    }
+    // Recopie les noeuds dans l'ordre des valeurs, les uns à la suite des autres
+    char* position = (char*)(bloc + 1);
+    unsigned int rang = 0;
+    long long prefixe = 0;
+    while (courant != NULL) {
+        Noeud nouveau = (Noeud)position;
+        position += taille_noeud(courant->hauteur);
+        nouveau->hauteur = courant->hauteur;
+        nouveau->valeur = courant->valeur;
+        nouveau->bloc = bloc;
+        lier_tableaux(nouveau);
+        rang++;
+        prefixe += nouveau->valeur;
+        // Ajoute le noeud à la fin de chacun de ses niveaux
         for (unsigned int i = 0; i < nouveau->hauteur; i++) {
-            nouveau->suivants[i] = suivants[i];
-            nouveau->precedents[i] = precedents[i];
+            Noeud dernier = d->derniers[i];
+            nouveau->suivants[i] = NULL;
+            nouveau->precedents[i] = dernier;
+            if (dernier == NULL)
+                d->premiers[i] = nouveau;
+            else
+                dernier->suivants[i] = nouveau;
+            largeurs_de(d, dernier)[i] = rang - d->rangs[i];
+            sommes_de(d, dernier)[i] = prefixe - d->prefixes[i];
+            d->derniers[i] = nouveau;
+            d->rangs[i] = rang;
+            d->prefixes[i] = prefixe;
+        }
+        // Détruit l'ancien noeud
+        Noeud ancien = courant;
+        courant = courant->suivants[0];
+        detruire_noeud(ancien);
+    }
+    // Les derniers liens de chaque niveau vont jusqu'à la fin de la liste
+    for (unsigned int i = 0; i < d->hauteur; i++) {
+        largeurs_de(d, d->derniers[i])[i] = rang - d->rangs[i];
+        sommes_de(d, d->derniers[i])[i] = prefixe - d->prefixes[i];
+    }
+    d->nb_mutations = 0;
+}
+
+void skiplist_auto_compact(SkipList d, unsigned int nb_mutations) {
+    d->seuil = nb_mutations;
+}
+
+/**
+ * \brief Déplace le prochain noeud du compactage progressif à la suite du bloc ouvert
+ * \param d La liste compactée, dont le compactage progressif est en cours
+ */
+void deplacer_noeud(SkipList d) {
+    Noeud ancien = d->a_compacter;
+    d->a_compacter = ancien->suivants[0];
+    if (ancien->bloc != NULL && ancien->bloc == d->bloc_ouvert)
+        return;
+    // Ouvre un nouveau bloc quand le noeud ne tient plus dans le bloc ouvert
+    size_t taille = taille_noeud(ancien->hauteur);
+    if (taille > d->place_restante) {
+        size_t capacite = (taille > TAILLE_TRONCON) ? taille : TAILLE_TRONCON;
+        Noeud suivant = d->a_compacter;
+        terminer_compactage(d);
+        d->a_compacter = suivant;
+        d->bloc_ouvert = (Bloc)malloc(sizeof(struct s_bloc) + capacite);
+        assert(d->bloc_ouvert != NULL);
+        // Le bloc ouvert ne peut être libéré avant d'être fermé
+        d->bloc_ouvert->nb_noeuds = 1;
+        d->place = (char*)(d->bloc_ouvert + 1);
+        d->place_restante = capacite;
+    }
+    // Recopie le noeud avec ses tours
+    Noeud nouveau = (Noeud)d->place;
+    d->place += taille;
+    d->place_restante -= taille;
+    nouveau->hauteur = ancien->hauteur;
+    nouveau->valeur = ancien->valeur;
+    nouveau->bloc = d->bloc_ouvert;
+    nouveau->bloc->nb_noeuds++;
+    lier_tableaux(nouveau);
+    for (unsigned int i = 0; i < nouveau->hauteur; i++) {
+        nouveau->suivants[i] = ancien->suivants[i];
+        nouveau->precedents[i] = ancien->precedents[i];
+        nouveau->largeurs[i] = ancien->largeurs[i];
+        nouveau->sommes[i] = ancien->sommes[i];
+        // Les voisins du noeud le retrouvent à sa nouvelle place
+        if (nouveau->precedents[i] == NULL)
+            d->premiers[i] = nouveau;
+        else
+            nouveau->precedents[i]->suivants[i] = nouveau;
+        if (nouveau->suivants[i] == NULL)
+            d->derniers[i] = nouveau;
+        else
+            nouveau->suivants[i]->precedents[i] = nouveau;
+    }
+    detruire_noeud(ancien);
+}
+
+/**
+ * \brief Compte des insertions ou des suppressions et fait avancer le compactage progressif
+ * \param d La liste modifiée
+ * \param nombre Le nombre d'éléments insérés ou supprimés
+ */
+void compter_mutations(SkipList d, unsigned int nombre) {
+    d->nb_mutations += nombre;
+    if (d->a_compacter == NULL && d->seuil != 0 && d->nb_mutations >= d->seuil) {
+        // Commence un passage depuis le début de la liste
+        d->nb_mutations = 0;
+        d->a_compacter = d->premiers[0];
+    }
+    for (unsigned int j = 0; d->a_compacter != NULL && j < nombre*PAS_COMPACTAGE; j++)
+        deplacer_noeud(d);
+    if (d->a_compacter == NULL)
+        terminer_compactage(d);
+}
+
+/**
+ * \brief Descend dans la liste jusqu'à une valeur
+ * \param d La liste dans laquelle on descend
+ * \param value La valeur cherchée
+ * \param chemin Si non NULL, reçoit pour chaque niveau le dernier noeud de valeur inférieure à value,
+ * NULL si ce sont les premiers noeuds de la liste qui le suivent (vecteur de mise à jour),
+ * le rang et la somme des valeurs jusqu'à ces noeuds étant rangés dans d->rangs et d->prefixes.
+ * Si NULL, la descente s'arrête dès que la valeur est rencontrée.
+ * \param nb_operations Si non NULL, reçoit le nombre de noeuds visités
+ * \return Le noeud de valeur value, NULL s'il n'existe pas
+ */
+Noeud descendre(SkipList d, int value, Noeud* chemin, unsigned int* nb_operations) {
+    Noeud precedent = NULL;
+    Noeud* suivants = d->premiers;
+    unsigned int* largeurs = d->largeurs_premiers;
+    long long* sommes = d->sommes_premiers;
+    Noeud suivant = NULL;
+    unsigned int nb = 1;
+    unsigned int rang = 0;
+    long long prefixe = 0;
+    for (int i = (int)d->hauteur-1; i >= 0; i--) {
+        // Avance sur le niveau tant que les noeuds sont plus petits
+        suivant = suivants[i];
+        while (suivant != NULL && suivant->valeur < value) {
+            rang += largeurs[i];
+            prefixe += sommes[i];
+            precedent = suivant;
+            suivants = suivant->suivants;
+            largeurs = suivant->largeurs;
+            sommes = suivant->sommes;
+            suivant = suivants[i];
+            nb++;
         }
-        // Met à jour les noeuds suivants et précédents
+        if (chemin != NULL) {
+            chemin[i] = precedent;
+            d->rangs[i] = rang;
+            d->prefixes[i] = prefixe;
+        } else if (suivant != NULL && suivant->valeur == value)
+            break;
+    }
+    if (nb_operations != NULL)
+        *nb_operations = nb;
+    return (suivant != NULL && suivant->valeur == value) ? suivant : NULL;
+}
+
+SkipList skiplist_insert(SkipList d, int value) {
+    if (descendre(d, value, d->chemin, NULL) == NULL) {
+        // Crée le noeud à insérer
+        Noeud nouveau = creer_noeud(d, value);
+        unsigned int rang = d->rangs[0] + 1;
+        long long prefixe = d->prefixes[0] + value;
+        // L'insère après les noeuds du vecteur de mise à jour
         for (unsigned int i = 0; i < nouveau->hauteur; i++) {
-            if (nouveau->precedents[i] == NULL)
+            Noeud precedent = d->chemin[i];
+            Noeud suivant = (precedent == NULL) ? d->premiers[i] : precedent->suivants[i];
+            unsigned int* largeurs = largeurs_de(d, precedent);
+            long long* sommes = sommes_de(d, precedent);
+            nouveau->precedents[i] = precedent;
+            nouveau->suivants[i] = suivant;
+            if (precedent == NULL)
                 d->premiers[i] = nouveau;
             else
-                nouveau->precedents[i]->suivants[i] = nouveau;
-            if (nouveau->suivants[i] == NULL)
+                precedent->suivants[i] = nouveau;
+            if (suivant == NULL)
                 d->derniers[i] = nouveau;
             else
-                nouveau->suivants[i]->precedents[i] = nouveau;
+                suivant->precedents[i] = nouveau;
+            // Partage le lien du noeud précédent avec le nouveau noeud
+            nouveau->largeurs[i] = largeurs[i] + 1 - (rang - d->rangs[i]);
+            nouveau->sommes[i] = sommes[i] + value - (prefixe - d->prefixes[i]);
+            largeurs[i] = rang - d->rangs[i];
+            sommes[i] = prefixe - d->prefixes[i];
+        }
+        // Les liens plus hauts passent au-dessus du nouveau noeud
+        for (unsigned int i = nouveau->hauteur; i < d->hauteur; i++) {
+            largeurs_de(d, d->chemin[i])[i]++;
+            sommes_de(d, d->chemin[i])[i] += value;
         }
         d->nb_elements += 1;
+        compter_mutations(d, 1);
     }
     return d;
 }
 
 bool skiplist_search(SkipList d, int value, unsigned int *nb_operations) {
-    Noeud courant;
+    return descendre(d, value, NULL, nb_operations) != NULL;
+}
+
+/**
+ * \brief Compte les éléments de la liste inférieurs à une valeur, sans modifier la liste
+ * \param d La liste
+ * \param value La valeur
+ * \param egaux Si vrai, les éléments égaux à la valeur sont aussi comptés
+ * \param somme Reçoit la somme de ces éléments
+ * \return Le nombre de ces éléments
+ * \note Contrairement à descendre, aucun vecteur de mise à jour n'est rempli :
+ * plusieurs lecteurs peuvent compter en même temps dans la même liste.
+ */
+unsigned int compter_inferieurs(SkipList d, int value, bool egaux, long long* somme) {
     Noeud* suivants = d->premiers;
-    int max = noeud_haut(suivants, &courant, d->hauteur-1);
-    *nb_operations = 1;
-    while (max >= 0) {
-        if (suivants[max] != NULL) {
-            if (suivants[max]->valeur == value) {
-                return true;
-            }
-            else if (suivants[max]->valeur > value)
-                max--;
+    unsigned int* largeurs = d->largeurs_premiers;
+    long long* sommes = d->sommes_premiers;
+    unsigned int rang = 0;
+    long long prefixe = 0;
+    for (int i = (int)d->hauteur-1; i >= 0; i--) {
+        // Avance sur le niveau tant que les noeuds sont à compter
+        Noeud suivant = suivants[i];
+        while (suivant != NULL && (suivant->valeur < value || (egaux && suivant->valeur == value))) {
+            rang += largeurs[i];
+            prefixe += sommes[i];
+            suivants = suivant->suivants;
+            largeurs = suivant->largeurs;
+            sommes = suivant->sommes;
+            suivant = suivants[i];
+        }
+    }
+    *somme = prefixe;
+    return rang;
+}
+
+/**
+ * \brief Compte les éléments de la liste inférieurs ou égaux à une valeur
+ * \param d La liste
+ * \param value La valeur
+ * \param somme Reçoit la somme de ces éléments
+ * \return Le nombre de ces éléments
+ */
+unsigned int compter_jusqua(SkipList d, int value, long long* somme) {
+    return compter_inferieurs(d, value, true, somme);
+}
+
+/**
+ * \brief Compte les éléments de la liste strictement inférieurs à une valeur
+ * \param d La liste
+ * \param value La valeur
+ * \param somme Reçoit la somme de ces éléments
+ * \return Le nombre de ces éléments
+ */
+unsigned int compter_avant(SkipList d, int value, long long* somme) {
+    return compter_inferieurs(d, value, false, somme);
+}
+
+unsigned int skiplist_range_count(SkipList d, int lo, int hi) {
+    long long somme;
+    if (lo > hi)
+        return 0;
+    return compter_jusqua(d, hi, &somme) - compter_avant(d, lo, &somme);
+}
+
+long long skiplist_range_sum(SkipList d, int lo, int hi) {
+    long long avant, jusqua;
+    if (lo > hi)
+        return 0;
+    compter_jusqua(d, hi, &jusqua);
+    compter_avant(d, lo, &avant);
+    return jusqua - avant;
+}
+
+int skiplist_range_ith(SkipList d, int lo, int hi, unsigned int k) {
+    long long somme;
+    assert(lo <= hi);
+    unsigned int debut = compter_avant(d, lo, &somme);
+    assert(debut + k < compter_jusqua(d, hi, &somme));
+    return noeud_de_rang(d, debut + k + 1)->valeur;
+}
+
+SkipList skiplist_split(SkipList d, int key) {
+    terminer_compactage(d);
+    SkipList haut = skiplist_create((int)d->hauteur);
+    // La partie haute se compacte comme la liste d'origine
+    haut->seuil = d->seuil;
+    // Le vecteur de mise à jour donne, à chaque niveau, le dernier noeud de la partie basse
+    descendre(d, key, d->chemin, NULL);
+    unsigned int rang = d->rangs[0];
+    long long prefixe = d->prefixes[0];
+    for (unsigned int i = 0; i < d->hauteur; i++) {
+        Noeud precedent = d->chemin[i];
+        unsigned int* largeurs = largeurs_de(d, precedent);
+        long long* sommes = sommes_de(d, precedent);
+        Noeud suivant = (precedent == NULL) ? d->premiers[i] : precedent->suivants[i];
+        // Le premier noeud du niveau dans la partie haute, et son rang dans cette partie
+        haut->premiers[i] = suivant;
+        haut->largeurs_premiers[i] = d->rangs[i] + largeurs[i] - rang;
+        haut->sommes_premiers[i] = d->prefixes[i] + sommes[i] - prefixe;
+        if (suivant != NULL) {
+            suivant->precedents[i] = NULL;
+            haut->derniers[i] = d->derniers[i];
+        }
+        // Le dernier noeud du niveau dans la partie basse va jusqu'à la fin de la liste
+        if (precedent == NULL)
+            d->premiers[i] = NULL;
+        else
+            precedent->suivants[i] = NULL;
+        d->derniers[i] = precedent;
+        largeurs[i] = rang - d->rangs[i];
+        sommes[i] = prefixe - d->prefixes[i];
+    }
+    haut->nb_elements = d->nb_elements - rang;
+    d->nb_elements = rang;
+    return haut;
+}
+
+SkipList skiplist_concat(SkipList a, SkipList b) {
+    assert(a->hauteur == b->hauteur);
+    assert(a->nb_elements == 0 || b->nb_elements == 0 || a->derniers[0]->valeur < b->premiers[0]->valeur);
+    terminer_compactage(a);
+    terminer_compactage(b);
+    for (unsigned int i = 0; i < a->hauteur; i++) {
+        // Le lien qui allait jusqu'à la fin de a va jusqu'au premier noeud du niveau dans b
+        Noeud dernier = a->derniers[i];
+        Noeud premier = b->premiers[i];
+        largeurs_de(a, dernier)[i] += b->largeurs_premiers[i];
+        sommes_de(a, dernier)[i] += b->sommes_premiers[i];
+        if (premier == NULL)
+            continue;
+        if (dernier == NULL)
+            a->premiers[i] = premier;
+        else
+            dernier->suivants[i] = premier;
+        premier->precedents[i] = dernier;
+        a->derniers[i] = b->derniers[i];
+    }
+    a->nb_elements += b->nb_elements;
+    // Les noeuds appartiennent désormais à a
+    b->premiers[0] = NULL;
+    b->nb_elements = 0;
+    skiplist_delete(b);
+    return a;
+}
+
+/**
+ * \brief État d'une recherche menée dans un groupe de skiplist_search_batch
+ */
+struct s_recherche {
+    Noeud* suivants;    // Les noeuds suivants du dernier noeud visité
+    int max;            // La hauteur courante de la recherche
+    unsigned int rang;  // L'indice de la valeur recherchée
+};
+
+void skiplist_search_batch(SkipList d, const int *values, bool *found, unsigned int n) {
+    struct s_recherche groupe[TAILLE_GROUPE];
+    Noeud courant;
+    // Toutes les recherches partent de la même hauteur
+    int depart = noeud_haut(d->premiers, &courant, d->hauteur-1);
+    if (depart < 0) {
+        // La liste est vide
+        for (unsigned int i = 0; i < n; i++)
+            found[i] = false;
+        return;
+    }
+    unsigned int prochain = 0;
+    unsigned int actifs = 0;
+    // Remplit le groupe avec les premières recherches
+    while (actifs < TAILLE_GROUPE && prochain < n) {
+        found[prochain] = false;
+        groupe[actifs].suivants = d->premiers;
+        groupe[actifs].max = depart;
+        groupe[actifs].rang = prochain++;
+        actifs++;
+    }
+    PRECHARGER(courant);
+    while (actifs > 0) {
+        unsigned int i = 0;
+        // Avance chaque recherche d'un cran, le noeud à tester ayant été préchargé au tour précédent
+        while (i < actifs) {
+            struct s_recherche* r = &groupe[i];
+            int value = values[r->rang];
+            courant = r->suivants[r->max];
+            if (courant == NULL || courant->valeur > value)
+                // Le noeud est absent ou trop grand, on descend
+                r->max--;
+            else if (courant->valeur < value)
+                // Le noeud est plus petit, on avance sur la même hauteur
+                r->suivants = courant->suivants;
             else {
-                max = noeud_haut(suivants, &courant, suivants[max]->hauteur-1);
-                suivants = suivants[max]->suivants;
-                if (courant != NULL)
-                    ++*nb_operations;
+                found[r->rang] = true;
+                r->max = -1;
             }
-        } else
-            max--;
+            if (r->max < 0) {
+                // La recherche est terminée, elle est remplacée par la suivante
+                if (prochain < n) {
+                    found[prochain] = false;
+                    r->suivants = d->premiers;
+                    r->max = depart;
+                    r->rang = prochain++;
+                } else {
+                    *r = groupe[--actifs];
+                    continue;
+                }
+            }
+            // Précharge le prochain noeud à tester pendant que les autres recherches avancent,
+            // ainsi que son suivant à la même hauteur, lu si la recherche avance (suivants est à l'adresse de liens)
+            courant = r->suivants[r->max];
+            if (courant != NULL) {
+                PRECHARGER(courant);
+                PRECHARGER(courant->liens + r->max);
+            }
+            i++;
+        }
     }
-    return false;
 }
 
 void skiplist_afficher(SkipList sk) {
@@ -285,35 +811,133 @@ int skiplist_iterator_value(SkipListIterator it) {
 }
 
 SkipList skiplist_remove(SkipList d, int value) {
-    Noeud courant;
-    Noeud* suivants = d->premiers;
-    int max = noeud_haut(suivants, &courant, d->hauteur-1);
-    while (max >= 0) {
-        if (suivants[max] != NULL) {
-            if (suivants[max]->valeur == value) {
-                courant = suivants[max];
-                for (unsigned int i = 0; i < courant->hauteur; i++) {
-                    if (courant->suivants[i] != NULL)
-                        courant->suivants[i]->precedents[i] = courant->precedents[i];
-                    else
-                        d->derniers[i] = courant->precedents[i];
-                    if (courant->precedents[i] != NULL)
-                        courant->precedents[i]->suivants[i] = courant->suivants[i];
-                    else
-                        d->premiers[i] = courant->suivants[i];
-                }
-                detruire_noeud(courant);
-                d->nb_elements--;
-                return d;
-            }
-            else if (suivants[max]->valeur > value)
-                max--;
-            else {
-                max = noeud_haut(suivants, &courant, suivants[max]->hauteur-1);
-                suivants = suivants[max]->suivants;
-            }
-        } else
-            max--;
+    Noeud courant = descendre(d, value, d->chemin, NULL);
+    if (courant != NULL) {
+        // Raccorde les noeuds du vecteur de mise à jour à ses suivants
+        for (unsigned int i = 0; i < courant->hauteur; i++) {
+            Noeud precedent = d->chemin[i];
+            Noeud suivant = courant->suivants[i];
+            if (suivant != NULL)
+                suivant->precedents[i] = precedent;
+            else
+                d->derniers[i] = precedent;
+            if (precedent != NULL)
+                precedent->suivants[i] = suivant;
+            else
+                d->premiers[i] = suivant;
+            // Le lien du noeud précédent absorbe celui du noeud supprimé
+            largeurs_de(d, precedent)[i] += courant->largeurs[i] - 1;
+            sommes_de(d, precedent)[i] += courant->sommes[i] - value;
+        }
+        // Les liens plus hauts passaient au-dessus du noeud supprimé
+        for (unsigned int i = courant->hauteur; i < d->hauteur; i++) {
+            largeurs_de(d, d->chemin[i])[i]--;
+            sommes_de(d, d->chemin[i])[i] -= value;
+        }
+        if (courant == d->a_compacter)
+            d->a_compacter = courant->suivants[0];
+        recycler_noeud(d, courant);
+        d->nb_elements--;
+        compter_mutations(d, 1);
     }
     return d;
 }
+
+int skiplist_pop_min(SkipList d) {
+    assert(d->nb_elements > 0);
+    Noeud premier = d->premiers[0];
+    int valeur = premier->valeur;
+    // Le noeud est le premier de chacun de ses niveaux, ses liens deviennent ceux du début de la liste
+    for (unsigned int i = 0; i < premier->hauteur; i++) {
+        Noeud suivant = premier->suivants[i];
+        d->premiers[i] = suivant;
+        if (suivant == NULL)
+            d->derniers[i] = NULL;
+        else
+            suivant->precedents[i] = NULL;
+        d->largeurs_premiers[i] = premier->largeurs[i];
+        d->sommes_premiers[i] = premier->sommes[i];
+    }
+    // Les liens plus hauts passaient au-dessus du noeud
+    for (unsigned int i = premier->hauteur; i < d->hauteur; i++) {
+        d->largeurs_premiers[i]--;
+        d->sommes_premiers[i] -= valeur;
+    }
+    if (premier == d->a_compacter)
+        d->a_compacter = d->premiers[0];
+    recycler_noeud(d, premier);
+    d->nb_elements--;
+    compter_mutations(d, 1);
+    return valeur;
+}
+
+int skiplist_pop_max(SkipList d) {
+    assert(d->nb_elements > 0);
+    Noeud dernier = d->derniers[0];
+    int valeur = dernier->valeur;
+    // Le noeud est le dernier de chacun de ses niveaux, ses précédents vont jusqu'à la fin de la liste
+    for (unsigned int i = 0; i < dernier->hauteur; i++) {
+        Noeud precedent = dernier->precedents[i];
+        d->derniers[i] = precedent;
+        if (precedent == NULL)
+            d->premiers[i] = NULL;
+        else
+            precedent->suivants[i] = NULL;
+    }
+    // Tous les liens menant à la fin de la liste passaient par le noeud
+    for (unsigned int i = 0; i < d->hauteur; i++) {
+        largeurs_de(d, d->derniers[i])[i]--;
+        sommes_de(d, d->derniers[i])[i] -= valeur;
+    }
+    if (dernier == d->a_compacter)
+        d->a_compacter = NULL;
+    recycler_noeud(d, dernier);
+    d->nb_elements--;
+    compter_mutations(d, 1);
+    return valeur;
+}
+
+unsigned int skiplist_pop_min_n(SkipList d, int *out, unsigned int k) {
+    unsigned int n = (k < d->nb_elements) ? k : d->nb_elements;
+    if (n == 0)
+        return 0;
+    // Relève les n plus petites valeurs
+    Noeud premier = d->premiers[0];
+    Noeud courant = premier;
+    long long somme = 0;
+    for (unsigned int j = 0; j < n; j++) {
+        out[j] = courant->valeur;
+        somme += courant->valeur;
+        courant = courant->suivants[0];
+    }
+    int borne = out[n-1];
+    // Sur chaque niveau, le nouveau premier noeud est le premier qui dépasse la borne
+    for (unsigned int i = 0; i < d->hauteur; i++) {
+        Noeud suivant = d->premiers[i];
+        unsigned int rang = d->largeurs_premiers[i];
+        long long prefixe = d->sommes_premiers[i];
+        while (suivant != NULL && suivant->valeur <= borne) {
+            rang += suivant->largeurs[i];
+            prefixe += suivant->sommes[i];
+            suivant = suivant->suivants[i];
+        }
+        d->premiers[i] = suivant;
+        if (suivant == NULL)
+            d->derniers[i] = NULL;
+        else
+            suivant->precedents[i] = NULL;
+        d->largeurs_premiers[i] = rang - n;
+        d->sommes_premiers[i] = prefixe - somme;
+    }
+    if (d->a_compacter != NULL && d->a_compacter->valeur <= borne)
+        d->a_compacter = d->premiers[0];
+    // Recycle les noeuds retirés
+    for (unsigned int j = 0; j < n; j++) {
+        courant = premier;
+        premier = premier->suivants[0];
+        recycler_noeud(d, courant);
+    }
+    d->nb_elements -= n;
+    compter_mutations(d, n);
+    return n;
+}
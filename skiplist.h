@@ -130,6 +130,90 @@ SkipList skiplist_remove(SkipList d, int value);
  */
 bool skiplist_search(SkipList d, int value, unsigned int *nb_operations);
 
+/**
+ *  @brief Count the values of a SkipList that belong to a range.
+ *
+ * Each link of the list knows how many elements it skips, so the count only needs two descents.
+ * Like skiplist_range_sum and skiplist_range_ith, it only reads d, and may run concurrently with other readers.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_range_count : SkipList \f$\times\f$ int \f$\times\f$ int \f$\rightarrow\f$ unsigned int
+ * @endparblock
+ *	@param d the SkipList to access
+ *	@param lo the lower bound of the range
+ *	@param hi the upper bound of the range
+ *  @return the number of values v of the SkipList such that lo \f$\le\f$ v \f$\le\f$ hi, 0 if hi \f$<\f$ lo.
+ * @par Complexity
+ * @parblock
+ * \f$O(\log(skiplist\_size(d)))\f$ on average
+ * @endparblock
+ */
+unsigned int skiplist_range_count(SkipList d, int lo, int hi);
+
+/**
+ *  @brief Sum the values of a SkipList that belong to a range.
+ *
+ * Each link of the list knows the sum of the elements it skips, so the sum only needs two descents.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_range_sum : SkipList \f$\times\f$ int \f$\times\f$ int \f$\rightarrow\f$ long long
+ * @endparblock
+ *	@param d the SkipList to access
+ *	@param lo the lower bound of the range
+ *	@param hi the upper bound of the range
+ *  @return the sum of the values v of the SkipList such that lo \f$\le\f$ v \f$\le\f$ hi, 0 if hi \f$<\f$ lo.
+ * @par Complexity
+ * @parblock
+ * \f$O(\log(skiplist\_size(d)))\f$ on average
+ * @endparblock
+ */
+long long skiplist_range_sum(SkipList d, int lo, int hi);
+
+/**
+ *  @brief Access to the \f$k^{th}\f$ smallest value of a SkipList within a range.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_range_ith : SkipList \f$\times\f$ int \f$\times\f$ int \f$\times\f$ unsigned int \f$\rightarrow\f$ int
+ * @endparblock
+ *	@param d the SkipList to access
+ *	@param lo the lower bound of the range
+ *	@param hi the upper bound of the range
+ *	@param k the index, in the range, of the required value
+ *  @return the \f$k^{th}\f$ value, counting from 0, of the SkipList that is greater or equal to lo.
+ * @pre
+ *	lo \f$\le\f$ hi \f$\wedge\f$ k \f$<\f$ skiplist_range_count(d, lo, hi)
+ * @par Axioms
+ * @parblock
+ * skiplist_range_ith(d, lo, hi, k) = skiplist_ith(d, i + k) where i is the number of values of d lower than lo
+ * @endparblock
+ */
+int skiplist_range_ith(SkipList d, int lo, int hi, unsigned int k);
+
+/**
+ *  @brief Search for the presence of several values in a SkipList.
+ *
+ * The searches are run by small groups in lock-step : each search of a group goes one node forward
+ * in turn and the next node it will test is prefetched, so that the cache misses of the searches
+ * of a group overlap instead of being waited for one after the other.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_search_batch : SkipList \f$\times\f$ int[] \f$\times\f$ bool[] \f$\times\f$ unsigned int \f$\rightarrow\f$ void
+ * @endparblock
+ *	@param d the SkipList to search into
+ *	@param values the n values to search for
+ *	@param found on return, found[i] is true if values[i] was found, false otherwise
+ *	@param n the number of values to search for
+ * @par Axioms
+ * @parblock
+ * found[i] = skiplist_search(d, values[i])
+ * @endparblock
+ */
+void skiplist_search_batch(SkipList d, const int *values, bool *found, unsigned int n);
+
 /**
  *  @brief Apply an operator on each member of the SkipList, from the begining to the end.
  *
@@ -145,6 +229,135 @@ void skiplist_map(SkipList d, ScanOperator f, void *user_data);
 
 
 
+/**
+ *  @brief Lay the nodes of a SkipList out in ascending order in a single memory block.
+ *
+ * The nodes, with their towers, are copied one after the other following the order of their values,
+ * so that a scan of the list or a search among neighbouring values reads contiguous memory.
+ * The towers keep their heights and the list its values.
+ * The nodes inserted afterwards are allocated individually until the next compaction,
+ * and the memory of a block is reclaimed once all its nodes have been removed.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_compact : SkipList \f$\rightarrow\f$ void
+ * @endparblock
+ *	@param d the SkipList to compact
+ *	@warning the iterators on d are invalidated.
+ */
+void skiplist_compact(SkipList d);
+
+/**
+ *  @brief Make a SkipList compact itself progressively after a given number of modifications.
+ *
+ * Once nb_mutations insertions or removals have modified the list since the start of the last pass,
+ * a new pass walks the list from its first node. Each following insertion or removal then moves
+ * a bounded number of nodes (8 per modified value) after the previous ones, so that no operation pays
+ * for the whole list. The nodes are gathered in blocks of 64 KiB instead of a single block :
+ * the scans read contiguous memory within each block.
+ * A pass is abandoned by skiplist_split and skiplist_concat, and replaced by skiplist_compact.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_auto_compact : SkipList \f$\times\f$ unsigned int \f$\rightarrow\f$ void
+ * @endparblock
+ *	@param d the SkipList to configure
+ *	@param nb_mutations the number of modifications between the starts of two passes, 0 to never start one (default)
+ *	@warning while a pass is running, every insertion or removal invalidates the iterators on d.
+ */
+void skiplist_auto_compact(SkipList d, unsigned int nb_mutations);
+
+
+/**
+ *  @brief Split a SkipList in two at a given key.
+ *
+ * Only the links that cross the boundary are modified : the cost is the one of a search followed by
+ * a constant amount of work per level, whatever the size of the list.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_split : SkipList \f$\times\f$ int \f$\rightarrow\f$ SkipList
+ * @endparblock
+ *	@param d the SkipList to split, that keeps the values lower than key
+ *	@param key the lowest value of the upper part
+ *  @return a new SkipList, with the same number of levels and the same skiplist_auto_compact setting,
+ *  made of the values of d greater or equal to key.
+ *	@note the parameter d is modified by side effect
+ *	@warning the iterators on d are invalidated.
+ */
+SkipList skiplist_split(SkipList d, int key);
+
+/**
+ *  @brief Concatenate two SkipLists whose values do not overlap.
+ *
+ * The towers of b are linked after the ones of a, level by level, without moving any node.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_concat : SkipList \f$\times\f$ SkipList \f$\rightarrow\f$ SkipList
+ * @endparblock
+ *	@param a the SkipList that receives the values of b
+ *	@param b the SkipList whose values are moved into a, then deleted
+ *  @return the modified SkipList a.
+ * @pre
+ *	a and b have the same number of levels and every value of a is lower than every value of b
+ *	@note the parameter a is modified by side effect and is returned by the function, b must not be used anymore
+ */
+SkipList skiplist_concat(SkipList a, SkipList b);
+
+
+/**
+ *  @brief Remove and return the smallest value of a SkipList.
+ *
+ * The first node is unlinked from the head of the list without any search.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_pop_min : SkipList \f$\rightarrow\f$ int
+ * @endparblock
+ *	@param d the SkipList to remove from
+ *  @return the value that was skiplist_ith(d, 0).
+ * @pre
+ *	skiplist_size(d) \f$>\f$ 0
+ *	@note the parameter d is modified by side effect
+ */
+int skiplist_pop_min(SkipList d);
+
+/**
+ *  @brief Remove and return the greatest value of a SkipList.
+ *
+ * The last node is unlinked from the tail of the list without any search.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_pop_max : SkipList \f$\rightarrow\f$ int
+ * @endparblock
+ *	@param d the SkipList to remove from
+ *  @return the value that was skiplist_ith(d, skiplist_size(d) - 1).
+ * @pre
+ *	skiplist_size(d) \f$>\f$ 0
+ *	@note the parameter d is modified by side effect
+ */
+int skiplist_pop_max(SkipList d);
+
+/**
+ *  @brief Remove the k smallest values of a SkipList.
+ *
+ * The head of each level is moved once for the whole batch, instead of once per removed value.
+ *
+ * @par Profile
+ * @parblock
+ *	skiplist_pop_min_n : SkipList \f$\times\f$ int[] \f$\times\f$ unsigned int \f$\rightarrow\f$ unsigned int
+ * @endparblock
+ *	@param d the SkipList to remove from
+ *	@param out on return, the removed values in ascending order
+ *	@param k the number of values to remove, out must be able to hold them
+ *  @return the number of removed values, k or skiplist_size(d) if the list had less than k values.
+ *	@note the parameter d is modified by side effect
+ */
+unsigned int skiplist_pop_min_n(SkipList d, int *out, unsigned int k);
+
+
 /*-----------------------*/
 /* Iterateur             */
 /*-----------------------*/
@@ -0,0 +1,502 @@
+#ifndef __DESKIPLIST_HPP__
+#define __DESKIPLIST_HPP__
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ *	@defgroup SkipListTemplate SkipList C++ template
+ *  @brief Header-only C++ front-end of the SkipList, specialized at compile time
+ *
+ *	The template keeps the algorithms of the C SkipList (doubly linked towers, heights drawn with the
+ *	law of rng_get_value() from the same seed, descent producing an update vector) but the comparator and
+ *	the operators applied to the elements are inlined, the number of levels is a compile-time constant
+ *	and the elements are (key, value) pairs of any types, the values possibly being move-only.
+ *  @{
+ */
+
+namespace skiplist {
+
+/**
+ *	@brief Ordered associative container implemented by a skip list.
+ *	@tparam Key type of the keys, ordered by Compare
+ *	@tparam Value type of the values associated to the keys, possibly move-only
+ *	@tparam Compare strict weak ordering of the keys, called inline
+ *	@tparam MaxLevel number of levels of the list
+ *	@tparam Allocator allocator of the elements, rebound to allocate the nodes with their towers
+ */
+template <typename Key, typename Value, typename Compare = std::less<Key>, unsigned int MaxLevel = 16,
+          typename Allocator = std::allocator<std::pair<const Key, Value>>>
+class SkipList {
+	static_assert(MaxLevel > 0, "a SkipList has at least one level");
+
+	template <bool Constant> class Iterator;
+
+public:
+	/// type of the keys
+	typedef Key key_type;
+	/// type of the values associated to the keys
+	typedef Value mapped_type;
+	/// type of the elements
+	typedef std::pair<const Key, Value> value_type;
+	/// type of the sizes
+	typedef std::size_t size_type;
+	/// type of the comparator of the keys
+	typedef Compare key_compare;
+	/// type of the allocator
+	typedef Allocator allocator_type;
+	/// reference on an element
+	typedef value_type &reference;
+	/// constant reference on an element
+	typedef const value_type &const_reference;
+	/// bidirectional iterator, in ascending order of the keys
+	typedef Iterator<false> iterator;
+	/// constant bidirectional iterator, in ascending order of the keys
+	typedef Iterator<true> const_iterator;
+	/// bidirectional iterator, in descending order of the keys
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	/// constant bidirectional iterator, in descending order of the keys
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	/// number of levels of the list
+	static constexpr unsigned int levels = MaxLevel;
+
+private:
+	struct Noeud {
+		Noeud **suivants;       // Les noeuds suivants
+		Noeud **precedents;     // Les noeuds précédents
+		unsigned int hauteur;   // La hauteur du noeud
+		value_type valeur;      // L'élément du noeud
+
+		template <typename... Args>
+		Noeud(unsigned int h, Noeud **liens, Args &&... args)
+			: suivants(liens), precedents(liens + h), hauteur(h), valeur(std::forward<Args>(args)...) {
+			for (unsigned int i = 0; i < 2 * h; i++)
+				liens[i] = nullptr;
+		}
+	};
+
+	// Unité d'allocation des noeuds : un noeud est suivi de ses tableaux de suivants et de précédents
+	typedef typename std::aligned_storage<sizeof(Noeud *), alignof(Noeud)>::type Unite;
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Unite> AllocateurNoeuds;
+	typedef std::allocator_traits<AllocateurNoeuds> TraitsNoeuds;
+	typedef std::array<Noeud *, MaxLevel> Tour;
+
+	/*
+	 * Générateur des hauteurs, identique à celui de rng.c : les hauteurs suivent la loi de rng_get_value()
+	 */
+	class Generateur {
+		unsigned long long etat_ = 0;
+
+		unsigned long long tirer() {
+			etat_ = (0x5deece66dULL * etat_ + 0xbULL) % 0x1000000000000ULL;
+			return (etat_ >> 17) & 0x7FFFFFFFULL;
+		}
+
+	public:
+		unsigned int hauteur() {
+			unsigned int valeur;
+			for (valeur = 0; tirer() < 0x7FFFFFFFULL / 2 && valeur < MaxLevel - 1; ++valeur);
+			return valeur + 1;
+		}
+	};
+
+	template <bool Constant>
+	class Iterator {
+		friend class SkipList;
+		typedef typename std::conditional<Constant, const SkipList, SkipList>::type Liste;
+
+		Liste *liste_;
+		Noeud *noeud_;
+
+		Iterator(Liste *liste, Noeud *noeud) : liste_(liste), noeud_(noeud) {}
+
+	public:
+		typedef std::bidirectional_iterator_tag iterator_category;
+		typedef typename SkipList::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef typename std::conditional<Constant, const value_type *, value_type *>::type pointer;
+		typedef typename std::conditional<Constant, const value_type &, value_type &>::type reference;
+
+		Iterator() : liste_(nullptr), noeud_(nullptr) {}
+		/// conversion of an iterator to a constant iterator
+		template <bool C, typename = typename std::enable_if<Constant && !C>::type>
+		Iterator(const Iterator<C> &it) : liste_(it.liste_), noeud_(it.noeud_) {}
+
+		reference operator*() const { return noeud_->valeur; }
+		pointer operator->() const { return &noeud_->valeur; }
+
+		Iterator &operator++() {
+			noeud_ = noeud_->suivants[0];
+			return *this;
+		}
+		Iterator operator++(int) {
+			Iterator it = *this;
+			++*this;
+			return it;
+		}
+		/// decrementing end() leads to the last element
+		Iterator &operator--() {
+			noeud_ = (noeud_ == nullptr) ? liste_->derniers_[0] : noeud_->precedents[0];
+			return *this;
+		}
+		Iterator operator--(int) {
+			Iterator it = *this;
+			--*this;
+			return it;
+		}
+
+		friend bool operator==(const Iterator &a, const Iterator &b) { return a.noeud_ == b.noeud_; }
+		friend bool operator!=(const Iterator &a, const Iterator &b) { return a.noeud_ != b.noeud_; }
+
+		template <bool> friend class Iterator;
+	};
+
+	Tour premiers_;                 // Les premiers noeuds de la liste
+	Tour derniers_;                 // Les derniers noeuds de la liste
+	size_type nb_elements_;         // Le nombre de noeuds dans la liste
+	Generateur generateur_;         // Générateur des hauteurs
+	Compare inferieur_;             // Comparateur des clés
+	AllocateurNoeuds allocateur_;   // Allocateur des noeuds
+
+public:
+	/**
+	 *	@brief Constructor of an empty SkipList.
+	 *	@param comp the comparator of the keys
+	 *	@param alloc the allocator of the elements
+	 */
+	explicit SkipList(const Compare &comp = Compare(), const Allocator &alloc = Allocator())
+		: nb_elements_(0), inferieur_(comp), allocateur_(alloc) {
+		premiers_.fill(nullptr);
+		derniers_.fill(nullptr);
+	}
+
+	/**
+	 *	@brief Copy constructor, only available if the elements may be copied.
+	 *	@param autre the SkipList to copy
+	 */
+	SkipList(const SkipList &autre)
+		: SkipList(autre.inferieur_,
+		           TraitsNoeuds::select_on_container_copy_construction(autre.allocateur_)) {
+		for (const value_type &element : autre)
+			ajouter(element);
+	}
+
+	/**
+	 *	@brief Move constructor, the moved SkipList becomes empty.
+	 *	@param autre the SkipList to move
+	 */
+	SkipList(SkipList &&autre) noexcept
+		: premiers_(autre.premiers_), derniers_(autre.derniers_), nb_elements_(autre.nb_elements_),
+		  generateur_(autre.generateur_), inferieur_(std::move(autre.inferieur_)),
+		  allocateur_(std::move(autre.allocateur_)) {
+		autre.premiers_.fill(nullptr);
+		autre.derniers_.fill(nullptr);
+		autre.nb_elements_ = 0;
+	}
+
+	/**
+	 *	@brief Copy and move assignment.
+	 *	@param autre the SkipList to copy or move
+	 *	@return this SkipList
+	 */
+	SkipList &operator=(SkipList autre) noexcept {
+		swap(autre);
+		return *this;
+	}
+
+	/**
+	 *	@brief Destructor of a SkipList.
+	 */
+	~SkipList() { clear(); }
+
+	/**
+	 *	@brief Exchange the contents of two SkipLists.
+	 *	@param autre the other SkipList
+	 */
+	void swap(SkipList &autre) noexcept {
+		using std::swap;
+		swap(premiers_, autre.premiers_);
+		swap(derniers_, autre.derniers_);
+		swap(nb_elements_, autre.nb_elements_);
+		swap(generateur_, autre.generateur_);
+		swap(inferieur_, autre.inferieur_);
+		swap(allocateur_, autre.allocateur_);
+	}
+
+	/// @return the number of elements of the SkipList.
+	size_type size() const noexcept { return nb_elements_; }
+	/// @return true if the SkipList has no element.
+	bool empty() const noexcept { return nb_elements_ == 0; }
+	/// @return the comparator of the keys.
+	key_compare key_comp() const { return inferieur_; }
+
+	/**
+	 *	@brief Remove all the elements of the SkipList.
+	 */
+	void clear() noexcept {
+		Noeud *courant = premiers_[0];
+		while (courant != nullptr) {
+			Noeud *suivant = courant->suivants[0];
+			detruire_noeud(courant);
+			courant = suivant;
+		}
+		premiers_.fill(nullptr);
+		derniers_.fill(nullptr);
+		nb_elements_ = 0;
+	}
+
+	iterator begin() noexcept { return iterator(this, premiers_[0]); }
+	const_iterator begin() const noexcept { return const_iterator(this, premiers_[0]); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	iterator end() noexcept { return iterator(this, nullptr); }
+	const_iterator end() const noexcept { return const_iterator(this, nullptr); }
+	const_iterator cend() const noexcept { return end(); }
+	reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+	const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+	const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+	const_reverse_iterator crend() const noexcept { return rend(); }
+
+	/**
+	 *	@brief Insert an element if its key is not in the SkipList.
+	 *	@param element the element to insert, copied or moved
+	 *	@return the iterator on the element of this key and true if the element was inserted.
+	 */
+	std::pair<iterator, bool> insert(const value_type &element) { return try_emplace(element.first, element.second); }
+	std::pair<iterator, bool> insert(value_type &&element) { return try_emplace(element.first, std::move(element.second)); }
+
+	/**
+	 *	@brief Insert an element built in place if its key is not in the SkipList.
+	 *
+	 *	Nothing is built, and the sequence of heights is not modified, when the key is already present.
+	 *	@param key the key of the element
+	 *	@param args the arguments of the constructor of the value
+	 *	@return the iterator on the element of this key and true if the element was inserted.
+	 */
+	template <typename K, typename... Args>
+	std::pair<iterator, bool> try_emplace(K &&key, Args &&... args) {
+		Tour chemin;
+		Noeud *existant = descendre(key, &chemin);
+		if (existant != nullptr)
+			return std::make_pair(iterator(this, existant), false);
+		Noeud *nouveau = creer_noeud(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+		                             std::forward_as_tuple(std::forward<Args>(args)...));
+		lier(nouveau, chemin);
+		return std::make_pair(iterator(this, nouveau), true);
+	}
+
+	/**
+	 *	@brief Access to the value of a key, inserting a default value if the key is not present.
+	 *	@param key the key
+	 *	@return the value associated to key.
+	 */
+	Value &operator[](const Key &key) { return try_emplace(key).first->second; }
+
+	/**
+	 *	@brief Remove the element of a given key.
+	 *	@param key the key to remove
+	 *	@return the number of removed elements (0 or 1).
+	 */
+	size_type erase(const Key &key) {
+		Noeud *courant = descendre(key, nullptr);
+		if (courant == nullptr)
+			return 0;
+		delier(courant);
+		return 1;
+	}
+
+	/**
+	 *	@brief Remove the element designed by an iterator, without searching it.
+	 *	@param position an iterator on an element of the SkipList
+	 *	@return the iterator on the following element.
+	 */
+	iterator erase(const_iterator position) {
+		Noeud *courant = position.noeud_;
+		Noeud *suivant = courant->suivants[0];
+		delier(courant);
+		return iterator(this, suivant);
+	}
+
+	/**
+	 *	@brief Search for a key.
+	 *	@param key the key to search for
+	 *	@return the iterator on the element of this key, end() if the key is not present.
+	 */
+	iterator find(const Key &key) { return iterator(this, descendre(key, nullptr)); }
+	const_iterator find(const Key &key) const { return const_iterator(this, descendre(key, nullptr)); }
+
+	/**
+	 *	@brief Search for the presence of a key.
+	 *	@param key the key to search for
+	 *	@return true if the key was found, false otherwise.
+	 */
+	bool contains(const Key &key) const { return descendre(key, nullptr) != nullptr; }
+
+	/**
+	 *	@brief Search for the presence of a key, counting the nodes tested as skiplist_search() does.
+	 *	@param key the key to search for
+	 *	@param nb_operations the number of tested nodes during the search
+	 *	@return true if the key was found, false otherwise.
+	 */
+	bool contains(const Key &key, unsigned int &nb_operations) const {
+		return descendre(key, nullptr, &nb_operations) != nullptr;
+	}
+
+	/**
+	 *	@brief First element whose key is not lower than a given key.
+	 *	@param key the bound
+	 *	@return the iterator on this element, end() if there is none.
+	 */
+	iterator lower_bound(const Key &key) {
+		Tour chemin;
+		descendre(key, &chemin);
+		return iterator(this, suivant(chemin[0], 0));
+	}
+	const_iterator lower_bound(const Key &key) const {
+		Tour chemin;
+		descendre(key, &chemin);
+		return const_iterator(this, suivant(chemin[0], 0));
+	}
+
+	/**
+	 *	@brief Apply an operator on each element of the SkipList, from the beginning to the end.
+	 *
+	 *	The operator is called inline, unlike the ScanOperator of skiplist_map().
+	 *	@param f the operator, called with a reference on each element
+	 */
+	template <typename Operator>
+	void for_each(Operator &&f) {
+		for (Noeud *courant = premiers_[0]; courant != nullptr; courant = courant->suivants[0])
+			f(courant->valeur);
+	}
+	template <typename Operator>
+	void for_each(Operator &&f) const {
+		for (const Noeud *courant = premiers_[0]; courant != nullptr; courant = courant->suivants[0])
+			f(courant->valeur);
+	}
+
+private:
+	static constexpr std::size_t nb_unites(unsigned int hauteur) {
+		return (sizeof(Noeud) + 2 * hauteur * sizeof(Noeud *) + sizeof(Unite) - 1) / sizeof(Unite);
+	}
+
+	template <typename... Args>
+	Noeud *creer_noeud(Args &&... args) {
+		unsigned int hauteur = generateur_.hauteur();
+		Unite *memoire = TraitsNoeuds::allocate(allocateur_, nb_unites(hauteur));
+		// Les tableaux de liens suivent le noeud
+		Noeud **liens = reinterpret_cast<Noeud **>(reinterpret_cast<char *>(memoire) + sizeof(Noeud));
+		try {
+			return ::new (static_cast<void *>(memoire)) Noeud(hauteur, liens, std::forward<Args>(args)...);
+		} catch (...) {
+			TraitsNoeuds::deallocate(allocateur_, memoire, nb_unites(hauteur));
+			throw;
+		}
+	}
+
+	void detruire_noeud(Noeud *nd) noexcept {
+		unsigned int hauteur = nd->hauteur;
+		nd->~Noeud();
+		TraitsNoeuds::deallocate(allocateur_, reinterpret_cast<Unite *>(nd), nb_unites(hauteur));
+	}
+
+	Noeud *suivant(Noeud *precedent, unsigned int i) const {
+		return (precedent == nullptr) ? premiers_[i] : precedent->suivants[i];
+	}
+
+	/*
+	 * Descend dans la liste jusqu'à une clé. Si chemin n'est pas nul, il reçoit le vecteur de mise à jour :
+	 * pour chaque niveau le dernier noeud de clé inférieure, nullptr pour le début de la liste.
+	 * Sinon la descente s'arrête dès que la clé est rencontrée.
+	 * Renvoie le noeud de cette clé, nullptr s'il n'existe pas.
+	 */
+	Noeud *descendre(const Key &key, Tour *chemin, unsigned int *nb_operations = nullptr) const {
+		Noeud *precedent = nullptr;
+		Noeud *const *suivants = premiers_.data();
+		Noeud *courant = nullptr;
+		unsigned int nb = 1;
+		for (int i = static_cast<int>(MaxLevel) - 1; i >= 0; i--) {
+			// Avance sur le niveau tant que les clés sont plus petites
+			courant = suivants[i];
+			while (courant != nullptr && inferieur_(courant->valeur.first, key)) {
+				precedent = courant;
+				suivants = courant->suivants;
+				courant = suivants[i];
+				nb++;
+			}
+			if (chemin != nullptr)
+				(*chemin)[i] = precedent;
+			else if (courant != nullptr && !inferieur_(key, courant->valeur.first))
+				break;
+		}
+		if (nb_operations != nullptr)
+			*nb_operations = nb;
+		return (courant != nullptr && !inferieur_(key, courant->valeur.first)) ? courant : nullptr;
+	}
+
+	// Insère un noeud après les noeuds du vecteur de mise à jour
+	void lier(Noeud *nouveau, const Tour &chemin) noexcept {
+		for (unsigned int i = 0; i < nouveau->hauteur; i++) {
+			Noeud *precedent = chemin[i];
+			Noeud *apres = suivant(precedent, i);
+			nouveau->precedents[i] = precedent;
+			nouveau->suivants[i] = apres;
+			if (precedent == nullptr)
+				premiers_[i] = nouveau;
+			else
+				precedent->suivants[i] = nouveau;
+			if (apres == nullptr)
+				derniers_[i] = nouveau;
+			else
+				apres->precedents[i] = nouveau;
+		}
+		nb_elements_++;
+	}
+
+	// Ajoute à la fin de la liste un élément plus grand que tous les autres
+	void ajouter(const value_type &element) {
+		Tour chemin = derniers_;
+		lier(creer_noeud(element), chemin);
+	}
+
+	// Raccorde les noeuds qui entourent un noeud puis le détruit
+	void delier(Noeud *courant) noexcept {
+		for (unsigned int i = 0; i < courant->hauteur; i++) {
+			Noeud *precedent = courant->precedents[i];
+			Noeud *apres = courant->suivants[i];
+			if (apres != nullptr)
+				apres->precedents[i] = precedent;
+			else
+				derniers_[i] = precedent;
+			if (precedent != nullptr)
+				precedent->suivants[i] = apres;
+			else
+				premiers_[i] = apres;
+		}
+		detruire_noeud(courant);
+		nb_elements_--;
+	}
+};
+
+/**
+ *	@brief Exchange the contents of two SkipLists.
+ */
+template <typename K, typename V, typename C, unsigned int L, typename A>
+void swap(SkipList<K, V, C, L, A> &a, SkipList<K, V, C, L, A> &b) noexcept {
+	a.swap(b);
+}
+
+} // namespace skiplist
+
+/** @} */
+
+#endif
@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "workload.h"
+
+void usage(const char *command) {
+	printf("usage : %s -g file [options]\n", command);
+	printf("        %s -r file\n", command);
+	printf("\tg : generate a trace into file, with the options :\n");
+	printf("\t\t-s seed : seed of the generation (0)\n");
+	printf("\t\t-n num : number of measured operations (1000000)\n");
+	printf("\t\t-p num : number of insertions before the measured operations (100000)\n");
+	printf("\t\t-k num : values are taken in [0, num[ (2000000)\n");
+	printf("\t\t-l num : number of levels of the list, at most %d (16)\n", WORKLOAD_MAX_LEVELS);
+	printf("\t\t-w num : number of values covered by a range operation (100)\n");
+	printf("\t\t-d law : uniform, zipf, sequential, sorted or adversarial (uniform)\n");
+	printf("\t\t-m insert,search,remove,ith,range : relative weights of the operations (30,60,10,0,0)\n");
+	printf("\tr : replay the trace read from file and print statistics about the operations\n");
+}
+
+bool lire_parametres(int argc, const char *argv[], WorkloadParameters *p) {
+	workload_default_parameters(p);
+	for (int i = 3; i < argc; i += 2) {
+		if (argv[i][0] != '-' || i + 1 >= argc)
+			return false;
+		const char *valeur = argv[i+1];
+		switch (argv[i][1]) {
+			case 's' :
+				p->seed = strtoull(valeur, NULL, 10);
+				break;
+			case 'n' :
+				p->nb_operations = (unsigned int)atoi(valeur);
+				break;
+			case 'p' :
+				p->nb_prefill = (unsigned int)atoi(valeur);
+				break;
+			case 'k' :
+				p->keyspace = (unsigned int)atoi(valeur);
+				break;
+			case 'l' :
+				p->nb_levels = (unsigned int)atoi(valeur);
+				break;
+			case 'w' :
+				p->range_width = (unsigned int)atoi(valeur);
+				break;
+			case 'd' :
+				p->distribution = workload_distribution_from_name(valeur);
+				break;
+			case 'm' :
+				if (sscanf(valeur, "%u,%u,%u,%u,%u", &p->mix[WORKLOAD_INSERT], &p->mix[WORKLOAD_SEARCH],
+						&p->mix[WORKLOAD_REMOVE], &p->mix[WORKLOAD_ITH], &p->mix[WORKLOAD_RANGE]) != 5)
+					return false;
+				break;
+			default :
+				return false;
+		}
+	}
+	unsigned int poids = 0;
+	for (unsigned int i = 0; i < WORKLOAD_NB_OPERATIONS; i++)
+		poids += p->mix[i];
+	return p->distribution < WORKLOAD_NB_DISTRIBUTIONS && p->keyspace > 0 && p->keyspace <= INT_MAX
+		&& p->nb_levels > 0 && p->nb_levels <= WORKLOAD_MAX_LEVELS && p->range_width > 0 && poids > 0;
+}
+
+void afficher_latences(const char *nom, const WorkloadLatencies *l) {
+	printf("    %-8s %10llu %10llu %10llu %10llu %10llu\n", nom, l->p50, l->p90, l->p99, l->p999, l->max);
+}
+
+void afficher_rapport(const char *nom_fichier, const WorkloadReport *r) {
+	const WorkloadParameters *p = &r->parameters;
+	printf("Trace %s :\n", nom_fichier);
+	printf("    Seed %llu, %s values in [0, %u[, %u levels\n", p->seed, workload_distribution_name(p->distribution), p->keyspace, p->nb_levels);
+	printf("    Prefill : %u insertions\n", p->nb_prefill);
+	printf("Replay of %u operations :\n", p->nb_operations);
+	for (unsigned int i = 0; i < WORKLOAD_NB_OPERATIONS; i++)
+		printf("    %-8s %10llu (hits %llu)\n", workload_operation_name((WorkloadOperation)i), r->count[i], r->hits[i]);
+	printf("    Final size of the list : %u\n", r->final_size);
+	printf("    Checksum : %016llx\n", r->checksum);
+	printf("Performances :\n");
+	printf("    Duration : %.3f s\n", r->seconds);
+	if (r->seconds > 0)
+		printf("    Throughput : %.0f operations/s\n", p->nb_operations / r->seconds);
+	printf("Latencies (ns) :\n");
+	printf("    %-8s %10s %10s %10s %10s %10s\n", "", "p50", "p90", "p99", "p99.9", "max");
+	for (unsigned int i = 0; i < WORKLOAD_NB_OPERATIONS; i++)
+		if (r->count[i] > 0)
+			afficher_latences(workload_operation_name((WorkloadOperation)i), &r->latencies[i]);
+	afficher_latences("all", &r->total);
+}
+
+int main(int argc, const char *argv[]){
+	if (argc < 3 || argv[1][0] != '-') {
+		usage(argv[0]);
+		return 1;
+	}
+	WorkloadParameters parametres;
+	WorkloadReport rapport;
+	switch (argv[1][1]) {
+		case 'g' :
+			if (!lire_parametres(argc, argv, &parametres)) {
+				usage(argv[0]);
+				return 1;
+			}
+			if (!workload_generate(&parametres, argv[2])) {
+				perror(argv[2]);
+				return 1;
+			}
+			break;
+		case 'r' :
+			if (!workload_replay(argv[2], &rapport)) {
+				fprintf(stderr, "%s : not a valid trace\n", argv[2]);
+				return 1;
+			}
+			afficher_rapport(argv[2], &rapport);
+			break;
+		default :
+			usage(argv[0]);
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,258 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "skiplist.hpp"
+
+/*
+ * Rejoue les scénarios c, s, i et r de skiplisttest avec le template, sur les mêmes fichiers :
+ * les hauteurs étant tirées de la même façon, les sorties sont identiques à celles des références.
+ * Les valeurs associées aux clés ne peuvent qu'être déplacées.
+ * Le scénario m utilise les autres membres du template, avec des clés copiables et un autre comparateur,
+ * et compare leurs résultats à ceux de std::map.
+ */
+
+void usage(const char *command) {
+	std::printf("usage : %s -id num\n", command);
+	std::printf("where id is :\n");
+	std::printf("\tc : construct and print the skiplist with data read from file test_files/construct_num.txt\n");
+	std::printf("\ts : construct the skiplist with data read from file test_files/construct_num.txt and search elements from file test_files/search_num.txt\n\t\tPrint statistics about the searches.\n");
+	std::printf("\ti : construct the skiplist with data read from file test_files/construct_num.txt and search, using an iterator, elements read from file test_files/search_num.txt\n\t\tPrint statistics about the searches.\n");
+	std::printf("\tr : construct the skiplist with data read from file test_files/construct_num.txt, remove values read from file test_files/remove_num.txt and print the list in reverse order\n");
+	std::printf("\tm : insert, copy, search and remove the values read from file test_files/construct_num.txt as strings in decreasing order, and check the results against std::map\n");
+	std::printf("where num is the file number for input\n");
+}
+
+std::ifstream ouvrir(const char *prefixe, int num) {
+	std::string nom_fichier = std::string(prefixe) + std::to_string(num) + ".txt";
+	std::ifstream fichier(nom_fichier);
+	if (!fichier) {
+		std::perror(nom_fichier.c_str());
+		std::exit(1);
+	}
+	return fichier;
+}
+
+template <unsigned int Niveaux>
+using Liste = skiplist::SkipList<int, std::unique_ptr<int>, std::less<int>, Niveaux>;
+
+template <unsigned int Niveaux>
+void construire_liste(std::ifstream &fichier, Liste<Niveaux> &sk) {
+	int nb_valeur;
+	fichier >> nb_valeur;
+	for (int i = 0; i < nb_valeur; i++) {
+		int nb;
+		fichier >> nb;
+		sk.try_emplace(nb, std::make_unique<int>(nb));
+	}
+}
+
+void afficher_stat(unsigned int taille, unsigned int nb_valeur, unsigned int nb_found, unsigned int min, unsigned int max, unsigned int total_operations) {
+	std::printf("Statistics : \n");
+	std::printf("    Size of the list : %d\n", taille);
+	std::printf("Search %d values :\n", nb_valeur);
+	std::printf("    Found %d\n", nb_found);
+	std::printf("    Not found %d\n", nb_valeur - nb_found);
+	std::printf("    Min number of operations : %d\n", min);
+	std::printf("    Max number of operations : %d\n", max);
+	std::printf("    Mean number of operations : %d\n", total_operations / nb_valeur);
+}
+
+template <unsigned int Niveaux>
+using ListeChaines = skiplist::SkipList<std::string, int, std::greater<std::string>, Niveaux>;
+typedef std::map<std::string, int, std::greater<std::string>> Modele;
+
+/*
+ * Compare le contenu d'une liste à celui du modèle, dans les deux sens et à travers des itérateurs constants
+ */
+template <unsigned int Niveaux>
+bool identiques(const ListeChaines<Niveaux> &sk, const Modele &modele) {
+	if (sk.size() != modele.size() || sk.empty() != modele.empty())
+		return false;
+	auto element = modele.cbegin();
+	for (auto it = sk.cbegin(); it != sk.cend(); ++it, ++element)
+		if (*it != *element)
+			return false;
+	auto inverse = modele.crbegin();
+	for (auto it = sk.crbegin(); it != sk.crend(); ++it, ++inverse)
+		if (*it != *inverse)
+			return false;
+	return true;
+}
+
+/*
+ * Compare un itérateur de la liste à un itérateur du modèle
+ */
+template <typename Iterateur>
+bool memes(Iterateur it, Iterateur fin, Modele::const_iterator element, Modele::const_iterator fin_modele) {
+	if (it == fin || element == fin_modele)
+		return (it == fin) == (element == fin_modele);
+	return *it == *element;
+}
+
+template <unsigned int Niveaux>
+void tester_membres(std::ifstream &construction) {
+	ListeChaines<Niveaux> sk;
+	Modele modele;
+	int nb_valeur;
+	construction >> nb_valeur;
+	bool identique = true;
+	// Insère par les deux insert et par operator[], les clés répétées étant comptées
+	for (int i = 0; identique && i < nb_valeur; i++) {
+		int nb;
+		construction >> nb;
+		std::string cle = std::to_string(nb);
+		if (i % 3 == 0) {
+			auto resultat = sk.insert(std::make_pair(cle, nb));
+			auto attendu = modele.insert(std::make_pair(cle, nb));
+			identique = resultat.second == attendu.second && *resultat.first == *attendu.first;
+		} else if (i % 3 == 1) {
+			const typename ListeChaines<Niveaux>::value_type element(cle, nb);
+			auto resultat = sk.insert(element);
+			auto attendu = modele.insert(element);
+			identique = resultat.second == attendu.second && *resultat.first == *attendu.first;
+		} else {
+			sk[cle] += nb;
+			modele[cle] += nb;
+		}
+	}
+	identique = identique && identiques(sk, modele);
+	// Copie la liste, par construction puis par affectation
+	ListeChaines<Niveaux> copie(sk);
+	ListeChaines<Niveaux> affectee;
+	affectee.try_emplace("?", 0);
+	affectee = copie;
+	identique = identique && identiques(copie, modele) && identiques(affectee, modele);
+	// Retire une clé sur deux de la copie par un itérateur, puis une sur trois par la clé
+	Modele reduit(modele);
+	unsigned int rang = 0;
+	for (const auto &element : modele) {
+		if (!identique)
+			break;
+		if (rang % 2 == 0) {
+			typename ListeChaines<Niveaux>::const_iterator position = copie.find(element.first);
+			auto suivant = copie.erase(position);
+			auto attendu = reduit.erase(reduit.find(element.first));
+			identique = memes(suivant, copie.end(), attendu, reduit.cend());
+		} else if (rang % 3 == 0)
+			identique = copie.erase(element.first) == reduit.erase(element.first) && copie.erase(element.first) == 0;
+		rang++;
+	}
+	identique = identique && identiques(copie, reduit);
+	// Cherche dans la copie, à travers une référence constante, les clés de la liste et des clés absentes
+	const ListeChaines<Niveaux> &constante = copie;
+	for (const auto &element : modele) {
+		for (const std::string &cle : {element.first, element.first + "5"}) {
+			if (!identique)
+				break;
+			identique = memes(constante.find(cle), constante.end(), reduit.find(cle), reduit.cend())
+				&& memes(constante.lower_bound(cle), constante.end(), reduit.lower_bound(cle), reduit.cend())
+				&& memes(copie.lower_bound(cle), copie.end(), reduit.lower_bound(cle), reduit.cend())
+				&& constante.contains(cle) == (reduit.count(cle) == 1);
+		}
+	}
+	// La liste d'origine et celle affectée ne partagent rien avec la copie
+	identique = identique && identiques(sk, modele) && identiques(affectee, modele);
+	if (identique)
+		std::printf("Template members (%u levels) : %u elements, %u after removals, no difference\n", Niveaux,
+		            (unsigned int)sk.size(), (unsigned int)copie.size());
+	else
+		std::printf("Template members (%u levels) : difference with std::map\n", Niveaux);
+}
+
+template <unsigned int Niveaux>
+void tester(char id, int num, std::ifstream &construction) {
+	if (id == 'm') {
+		tester_membres<Niveaux>(construction);
+		return;
+	}
+	Liste<Niveaux> sk;
+	construire_liste(construction, sk);
+	if (id == 'c') {
+		std::printf("Skiplist (%d)\n", (int)sk.size());
+		sk.for_each([](const typename Liste<Niveaux>::value_type &element) { std::printf("%d ", *element.second); });
+	} else if (id == 's' || id == 'i') {
+		std::ifstream fichier = ouvrir("test_files/search_", num);
+		unsigned int nb_valeur;
+		fichier >> nb_valeur;
+		unsigned int nb_found = 0;
+		unsigned int min = (unsigned int)sk.size();
+		unsigned int max = 0;
+		unsigned int total_operations = 0;
+		for (unsigned int i = 0; i < nb_valeur; i++) {
+			int nb;
+			fichier >> nb;
+			unsigned int nb_operations = 0;
+			bool trouve = false;
+			if (id == 's')
+				trouve = sk.contains(nb, nb_operations);
+			else
+				for (auto it = sk.begin(); !trouve && it != sk.end(); ++it) {
+					nb_operations++;
+					trouve = it->first == nb;
+				}
+			if (trouve)
+				nb_found++;
+			std::printf("%d -> %s\n", nb, trouve ? "true" : "false");
+			total_operations += nb_operations;
+			if (min > nb_operations)
+				min = nb_operations;
+			if (max < nb_operations)
+				max = nb_operations;
+		}
+		afficher_stat((unsigned int)sk.size(), nb_valeur, nb_found, min, max, total_operations);
+	} else {
+		std::ifstream fichier = ouvrir("test_files/remove_", num);
+		unsigned int nb_valeur;
+		fichier >> nb_valeur;
+		for (unsigned int i = 0; i < nb_valeur; i++) {
+			int nb;
+			fichier >> nb;
+			sk.erase(nb);
+		}
+		// Déplace la liste pour vérifier que les noeuds suivent
+		Liste<Niveaux> deplacee(std::move(sk));
+		std::printf("Skiplist (%d)\n", (int)deplacee.size());
+		for (auto it = deplacee.rbegin(); it != deplacee.rend(); ++it)
+			std::printf("%d ", *it->second);
+	}
+}
+
+/*
+ * Instancie le template avec le nombre de niveaux lu dans le fichier de construction
+ */
+template <unsigned int Niveaux>
+void lancer(unsigned int niveaux, char id, int num, std::ifstream &construction) {
+	if (niveaux == Niveaux)
+		tester<Niveaux>(id, num, construction);
+	else
+		lancer<Niveaux - 1>(niveaux, id, num, construction);
+}
+
+template <>
+void lancer<0>(unsigned int niveaux, char, int, std::ifstream &) {
+	std::fprintf(stderr, "%u levels are not supported\n", niveaux);
+	std::exit(1);
+}
+
+int main(int argc, const char *argv[]) {
+	if (argc < 3 || argv[1][0] != '-') {
+		usage(argv[0]);
+		return 1;
+	}
+	char id = argv[1][1];
+	if (id != 'c' && id != 's' && id != 'i' && id != 'r' && id != 'm') {
+		usage(argv[0]);
+		return 1;
+	}
+	int num = std::atoi(argv[2]);
+	std::ifstream construction = ouvrir("test_files/construct_", num);
+	unsigned int niveaux;
+	construction >> niveaux;
+	lancer<16>(niveaux, id, num, construction);
+	return 0;
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 #include "skiplist.h"
 
@@ -12,8 +13,12 @@ void usage(const char *command) {
 	printf("\tc : construct and print the skiplist with data read from file test_files/construct_num.txt\n");
 	printf("\ts : construct the skiplist with data read from file test_files/construct_num.txt and search elements from file test_files/search_num..txt\n\t\tPrint statistics about the searches.\n");
 	printf("\ti : construct the skiplist with data read from file test_files/construct_num.txt and search, using an iterator, elements read from file test_files/search_num.txt\n\t\tPrint statistics about the searches.\n");
+	printf("\tb : construct the skiplist with data read from file test_files/construct_num.txt and search, by batches, elements read from file test_files/search_num.txt\n");
 	printf("\tr : construct the skiplist with data read from file test_files/construct_num.txt, remove values read from file test_files/remove_num.txt and print the list in reverse order\n");
-	printf("where num is the file number for input\n");
+	printf("\tk : same as r, the list being compacted after its construction, progressively every 3 removals and at the end\n");
+	printf("\td : apply random operations to a skiplist and to a sorted array, and check that they always agree\n");
+	printf("\tq : use a compacted skiplist as a queue, popping and inserting values at both ends\n");
+	printf("where num is the file number for input (the seed for d)\n");
 }
 
 char* construire_nom (char* prefix, int num) {
@@ -155,8 +160,41 @@ void test_search_iterator(int num){
 	skiplist_iterator_delete(it);
 }
 
-void test_remove(int num){
+void test_search_batch(int num) {
 	SkipList sk = construire_liste(num);
+	char* nom_fichier = construire_nom("test_files/search_", num);
+	FILE* fichier = NULL;
+	if ((fichier = fopen(nom_fichier, "r")) == NULL) {
+		perror(nom_fichier);
+		exit(1);
+	}
+	free(nom_fichier);
+	char buffer[MAX_BUFFER];
+	unsigned int nb_valeur = (unsigned int)atoi(fgets(buffer, MAX_BUFFER, fichier));
+	int* valeurs = (int*)malloc(sizeof(int)*nb_valeur);
+	bool* trouves = (bool*)malloc(sizeof(bool)*nb_valeur);
+	for (unsigned int i = 0; i < nb_valeur; i++)
+		valeurs[i] = atoi(fgets(buffer, MAX_BUFFER, fichier));
+	fclose(fichier);
+	skiplist_search_batch(sk, valeurs, trouves, nb_valeur);
+	for (unsigned int i = 0; i < nb_valeur; i++) {
+		if (trouves[i])
+			printf("%d -> true\n", valeurs[i]);
+		else
+			printf("%d -> false\n", valeurs[i]);
+	}
+	free(valeurs);
+	free(trouves);
+	skiplist_delete(sk);
+}
+
+void test_remove(int num, bool compacter){
+	SkipList sk = construire_liste(num);
+	if (compacter) {
+		// Compacte la liste construite, puis progressivement toutes les 3 suppressions
+		skiplist_compact(sk);
+		skiplist_auto_compact(sk, 3);
+	}
 	char* nom_fichier = construire_nom("test_files/remove_", num);
 	FILE* fichier = NULL;
 	if ((fichier = fopen(nom_fichier, "r")) == NULL) {
@@ -171,6 +209,8 @@ void test_remove(int num){
 		skiplist_remove(sk, nb);
 	}
 	fclose(fichier);
+	if (compacter)
+		skiplist_compact(sk);
 	printf("Skiplist (%d)\n", skiplist_size(sk));
 	SkipListIterator it = skiplist_iterator_create(sk, BACKWARD_ITERATOR);
 	for (it = skiplist_iterator_begin(it); !skiplist_iterator_end(it); it = skiplist_iterator_next(it))
@@ -179,6 +219,187 @@ void test_remove(int num){
 	skiplist_delete(sk);
 }
 
+/**
+ * \brief Générateur pseudo-aléatoire (xorshift) propre au test différentiel, pour qu'il soit identique sur toutes les plateformes
+ */
+unsigned int aleatoire(unsigned int *etat) {
+	*etat ^= *etat << 13;
+	*etat ^= *etat >> 17;
+	*etat ^= *etat << 5;
+	return *etat;
+}
+
+/**
+ * \brief Recherche dichotomique dans un tableau trié
+ * \return La position de la valeur ou, si elle est absente, celle où l'insérer
+ */
+unsigned int position_triee(const int *tableau, unsigned int taille, int valeur) {
+	unsigned int debut = 0, fin = taille;
+	while (debut < fin) {
+		unsigned int milieu = debut + (fin - debut) / 2;
+		if (tableau[milieu] < valeur)
+			debut = milieu + 1;
+		else
+			fin = milieu;
+	}
+	return debut;
+}
+
+/**
+ * \brief Compare tout le contenu de la liste, dans les deux sens, à celui du tableau
+ */
+bool comparer_contenu(SkipList sk, const int *oracle, unsigned int taille) {
+	if (skiplist_size(sk) != taille)
+		return false;
+	bool identique = true;
+	unsigned int i = 0;
+	SkipListIterator it = skiplist_iterator_create(sk, FORWARD_ITERATOR);
+	for (it = skiplist_iterator_begin(it); identique && !skiplist_iterator_end(it); it = skiplist_iterator_next(it))
+		identique = i < taille && skiplist_iterator_value(it) == oracle[i++];
+	identique = identique && i == taille;
+	skiplist_iterator_delete(it);
+	it = skiplist_iterator_create(sk, BACKWARD_ITERATOR);
+	for (it = skiplist_iterator_begin(it); identique && !skiplist_iterator_end(it); it = skiplist_iterator_next(it))
+		identique = i > 0 && skiplist_iterator_value(it) == oracle[--i];
+	skiplist_iterator_delete(it);
+	// Vérifie les largeurs et les sommes des liens
+	long long somme = 0;
+	for (i = 0; identique && i < taille; i++) {
+		identique = skiplist_ith(sk, i) == oracle[i];
+		somme += oracle[i];
+	}
+	return identique && skiplist_range_sum(sk, INT_MIN, INT_MAX) == somme;
+}
+
+void test_differential(int num) {
+	unsigned int etat = 2463534242u ^ (unsigned int)num;
+	int nb_levels = 1 + 4 * ((num - 1) % 4);
+	unsigned int amplitude = 500 * (unsigned int)num;
+	unsigned int nb_operations = 20000;
+	SkipList sk = skiplist_create(nb_levels);
+	// Le compactage progressif déplace des noeuds pendant les opérations
+	skiplist_auto_compact(sk, 200);
+	int *oracle = (int*)malloc(sizeof(int)*amplitude);
+	unsigned int taille = 0;
+	bool identique = true;
+	unsigned int k;
+	for (k = 0; identique && k < nb_operations; k++) {
+		int valeur = (int)(aleatoire(&etat) % amplitude) - (int)amplitude / 2;
+		unsigned int position = position_triee(oracle, taille, valeur);
+		bool present = position < taille && oracle[position] == valeur;
+		unsigned int choix = aleatoire(&etat) % 100;
+		unsigned int nb_visites;
+		if (choix < 40) {
+			skiplist_insert(sk, valeur);
+			if (!present) {
+				memmove(oracle + position + 1, oracle + position, sizeof(int)*(taille - position));
+				oracle[position] = valeur;
+				taille++;
+			}
+			identique = skiplist_size(sk) == taille;
+		} else if (choix < 70) {
+			skiplist_remove(sk, valeur);
+			if (present) {
+				memmove(oracle + position, oracle + position + 1, sizeof(int)*(taille - position - 1));
+				taille--;
+			}
+			identique = skiplist_size(sk) == taille;
+		} else if (choix < 90) {
+			identique = skiplist_search(sk, valeur, &nb_visites) == present && nb_visites >= 1;
+			// Vérifie les requêtes sur l'intervalle commençant à la valeur
+			int borne = valeur + (int)amplitude / 10;
+			unsigned int fin = position_triee(oracle, taille, borne);
+			if (fin < taille && oracle[fin] == borne)
+				fin++;
+			long long somme = 0;
+			for (unsigned int j = position; j < fin; j++)
+				somme += oracle[j];
+			identique = identique && skiplist_range_count(sk, valeur, borne) == fin - position
+				&& skiplist_range_sum(sk, valeur, borne) == somme
+				&& skiplist_range_count(sk, borne, valeur) == 0;
+			if (identique && fin > position)
+				identique = skiplist_range_ith(sk, valeur, borne, (fin - position) / 2) == oracle[position + (fin - position) / 2];
+		} else if (choix < 95) {
+			if (taille > 0) {
+				unsigned int rang = aleatoire(&etat) % taille;
+				identique = skiplist_ith(sk, rang) == oracle[rang];
+			}
+		} else {
+			int valeurs[16];
+			bool trouves[16];
+			for (unsigned int j = 0; j < 16; j++)
+				valeurs[j] = (int)(aleatoire(&etat) % amplitude) - (int)amplitude / 2;
+			skiplist_search_batch(sk, valeurs, trouves, 16);
+			for (unsigned int j = 0; identique && j < 16; j++) {
+				position = position_triee(oracle, taille, valeurs[j]);
+				identique = trouves[j] == (position < taille && oracle[position] == valeurs[j]);
+			}
+		}
+		if (identique && k % 1000 == 999)
+			identique = comparer_contenu(sk, oracle, taille);
+		if (k % 5000 == 4999)
+			skiplist_compact(sk);
+		if (identique && k % 2500 == 1249) {
+			// Coupe la liste à la valeur puis recolle les deux parties
+			SkipList haut = skiplist_split(sk, valeur);
+			position = position_triee(oracle, taille, valeur);
+			identique = comparer_contenu(sk, oracle, position) && comparer_contenu(haut, oracle + position, taille - position);
+			sk = skiplist_concat(sk, haut);
+		}
+		if (identique && k % 2500 == 624 && taille >= 5) {
+			// Retire les extrémités de la liste puis les réinsère
+			int extremites[5];
+			identique = skiplist_pop_min_n(sk, extremites, 3) == 3;
+			extremites[3] = skiplist_pop_max(sk);
+			extremites[4] = skiplist_pop_min(sk);
+			identique = identique && extremites[0] == oracle[0] && extremites[1] == oracle[1] && extremites[2] == oracle[2]
+				&& extremites[3] == oracle[taille-1] && extremites[4] == oracle[3];
+			identique = identique && comparer_contenu(sk, oracle + 4, taille - 5);
+			for (unsigned int j = 0; j < 5; j++)
+				skiplist_insert(sk, extremites[j]);
+		}
+	}
+	if (identique)
+		identique = comparer_contenu(sk, oracle, taille);
+	if (identique)
+		printf("Differential test (%d levels) : %u operations, size %u, no difference\n", nb_levels, nb_operations, taille);
+	else
+		printf("Differential test (%d levels) : difference after operation %u\n", nb_levels, k);
+	free(oracle);
+	skiplist_delete(sk);
+}
+
+void test_queue(int num) {
+	unsigned int taille = 5000 * (unsigned int)num;
+	unsigned int nb_tours = 400;
+	SkipList sk = skiplist_create(1 + 4 * ((num - 1) % 4));
+	// La liste contient les valeurs de [debut, fin[
+	int debut = 0;
+	int fin = (int)taille;
+	for (int v = debut; v < fin; v++)
+		skiplist_insert(sk, v);
+	skiplist_auto_compact(sk, 4);
+	bool identique = true;
+	unsigned int k;
+	for (k = 0; identique && k < nb_tours; k++) {
+		// Compacte puis retire les extrémités, les noeuds retirés ne devant pas retenir les anciens blocs
+		skiplist_compact(sk);
+		int extremites[2];
+		identique = skiplist_pop_min_n(sk, extremites, 2) == 2 && extremites[0] == debut && extremites[1] == debut + 1;
+		identique = identique && skiplist_pop_min(sk) == debut + 2 && skiplist_pop_max(sk) == fin - 1;
+		debut += 3;
+		fin -= 1;
+		for (int j = 0; j < 4; j++)
+			skiplist_insert(sk, fin++);
+		identique = identique && skiplist_size(sk) == taille && skiplist_ith(sk, 0) == debut;
+	}
+	if (identique)
+		printf("Queue test (%u values) : %u rounds, no difference\n", taille, nb_tours);
+	else
+		printf("Queue test (%u values) : difference at round %u\n", taille, k);
+	skiplist_delete(sk);
+}
+
 void generate(int nbvalues);
 
 
@@ -197,8 +418,20 @@ int main(int argc, const char *argv[]){
 		case 'i' :
 			test_search_iterator(atoi(argv[2]));
 			break;
+		case 'b' :
+			test_search_batch(atoi(argv[2]));
+			break;
 		case 'r' :
-			test_remove(atoi(argv[2]));
+			test_remove(atoi(argv[2]), false);
+			break;
+		case 'k' :
+			test_remove(atoi(argv[2]), true);
+			break;
+		case 'd' :
+			test_differential(atoi(argv[2]));
+			break;
+		case 'q' :
+			test_queue(atoi(argv[2]));
 			break;
 		case 'g' :
 			generate(atoi(argv[2]));
@@ -5,6 +5,9 @@ wipe='\e[00m';
 ok='\e[01;32m';
 
 COMMAND=skiplisttest
+BENCH=skiplistbench
+TEMPLATE=skiplisttemplate
+DISTRIBUTIONS=(uniform zipf sequential sorted adversarial)
 BASE=.
 TEST=./test_files
 RET=
@@ -72,6 +75,26 @@ function test_iterator {
     fi
 }
 
+function test_batch {
+    if [ -x $BASE/$COMMAND ]
+    then
+    rm -f $TEST/result_batch_$1.txt
+	$BASE/$COMMAND -b $1 > $TEST/result_batch_$1.txt  2>/dev/null
+	DIFF=`grep -e '->' $TEST/references/result_search_$1.txt | diff -b -E $TEST/result_batch_$1.txt -`
+	if [ $? -eq 0 ]
+	then
+		RET=0
+	else
+		echo "Erreur  : " $DIFF
+		RET=1
+	fi
+	rm -f $TEST/result_batch_$1.txt
+    else
+	echo "Command $BASE/$COMMAND not found"
+	RET=2
+    fi
+}
+
 function test_remove {
     if [ -x $BASE/$COMMAND ]
     then
@@ -94,6 +117,125 @@ function test_remove {
 }
 
 
+function test_compact {
+    if [ -x $BASE/$COMMAND ]
+    then
+    rm -f $TEST/result_compact_$1.txt
+	$BASE/$COMMAND -k $1 > $TEST/result_compact_$1.txt  2>/dev/null
+	DIFF=`diff -b -E $TEST/result_compact_$1.txt $TEST/references/result_remove_$1.txt`
+	if [ $? -eq 0 ]
+	then
+		RET=0
+	else
+		echo "Erreur  : " $DIFF
+		RET=1
+	fi
+	rm -f $TEST/result_compact_$1.txt
+    else
+	echo "Command $BASE/$COMMAND not found"
+	RET=2
+    fi
+}
+
+function test_differential {
+    if [ -x $BASE/$COMMAND ]
+    then
+    rm -f $TEST/result_differential_$1.txt
+	$BASE/$COMMAND -d $1 > $TEST/result_differential_$1.txt  2>/dev/null
+	DIFF=`diff -b -E $TEST/result_differential_$1.txt $TEST/references/result_differential_$1.txt`
+	if [ $? -eq 0 ]
+	then
+		RET=0
+	else
+		echo "Erreur  : " $DIFF
+		RET=1
+	fi
+	rm -f $TEST/result_differential_$1.txt
+    else
+	echo "Command $BASE/$COMMAND not found"
+	RET=2
+    fi
+}
+
+function test_queue {
+    if [ -x $BASE/$COMMAND ]
+    then
+    rm -f $TEST/result_queue_$1.txt
+	# La mémoire est limitée : les noeuds retirés ne doivent pas retenir les blocs des compactages précédents
+	( ulimit -v 32768; $BASE/$COMMAND -q $1 ) > $TEST/result_queue_$1.txt  2>/dev/null
+	DIFF=`diff -b -E $TEST/result_queue_$1.txt $TEST/references/result_queue_$1.txt`
+	if [ $? -eq 0 ]
+	then
+		RET=0
+	else
+		echo "Erreur  : " $DIFF
+		RET=1
+	fi
+	rm -f $TEST/result_queue_$1.txt
+    else
+	echo "Command $BASE/$COMMAND not found"
+	RET=2
+    fi
+}
+
+function test_template {
+    if [ -x $BASE/$TEMPLATE ]
+    then
+	RET=0
+	for MODE in c:construct s:search i:iterator r:remove m:members
+	do
+	rm -f $TEST/result_template_$1.txt
+	$BASE/$TEMPLATE -${MODE%%:*} $1 > $TEST/result_template_$1.txt  2>/dev/null
+	DIFF=`diff -b -E $TEST/result_template_$1.txt $TEST/references/result_${MODE#*:}_$1.txt`
+	if [ $? -ne 0 ]
+	then
+		echo "Erreur  : " $DIFF
+		RET=1
+	fi
+	rm -f $TEST/result_template_$1.txt
+	done
+    else
+	echo "Command $BASE/$TEMPLATE not found"
+	RET=2
+    fi
+}
+
+function test_workload {
+    if [ -x $BASE/$BENCH ]
+    then
+    rm -f $TEST/workload_$1.trace $TEST/workload_$1.bis $TEST/result_workload_$1.txt
+	OPTIONS="-s $1 -d ${DISTRIBUTIONS[$1-1]} -n 20000 -p 2000 -k 10000 -l 8 -w 50 -m 30,50,10,5,5"
+	$BASE/$BENCH -g $TEST/workload_$1.trace $OPTIONS
+	$BASE/$BENCH -g $TEST/workload_$1.bis $OPTIONS
+	$BASE/$BENCH -r $TEST/workload_$1.trace | sed -e '/^Performances/,$d' > $TEST/result_workload_$1.txt 2>/dev/null
+	DIFF=`cmp $TEST/workload_$1.trace $TEST/workload_$1.bis && diff -b -E $TEST/result_workload_$1.txt $TEST/references/result_workload_$1.txt`
+	VALIDE=$?
+	# Une entête annonçant trop de niveaux, une largeur nulle ou trop d'opérations doit être refusée
+	# sans interrompre le programme
+	for CHAMP in '8:\xff\xff\xff\x7f' '8:\x00\x00\x00\x02' '8:\x41\x00\x00\x00' '20:\x00\x00\x00\x00' \
+		'40:\xff\xff\xff\x7f\x00\x00\x00\x00' '40:\xff\xff\xff\xff\xff\x00\x00\x00'
+	do
+		cp $TEST/workload_$1.trace $TEST/workload_$1.bis
+		printf "${CHAMP#*:}" | dd of=$TEST/workload_$1.bis bs=1 seek=${CHAMP%%:*} conv=notrunc 2>/dev/null
+		$BASE/$BENCH -r $TEST/workload_$1.bis > /dev/null 2>&1
+		[ $? -eq 1 ] || { VALIDE=1; DIFF="corrupted trace not rejected"; }
+	done
+	$BASE/$BENCH -g $TEST/workload_$1.bis -l 65 > /dev/null 2>&1
+	[ $? -eq 1 ] || { VALIDE=1; DIFF="too many levels accepted"; }
+	if [ $VALIDE -eq 0 ]
+	then
+		RET=0
+	else
+		echo "Erreur  : " $DIFF
+		RET=1
+	fi
+	rm -f $TEST/workload_$1.trace $TEST/workload_$1.bis $TEST/result_workload_$1.txt
+    else
+	echo "Command $BASE/$BENCH not found"
+	RET=2
+    fi
+}
+
 function test {
  for i in $(seq 1 1 $2)
  do
@@ -106,5 +248,11 @@ function test {
 test construction 4;
 test search 4;
 test iterator 4;
+test batch 4;
 test remove 4;
+test compact 4;
+test differential 4;
+test queue 4;
+test template 4;
+test workload 5;
 exit 0
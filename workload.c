@@ -0,0 +1,439 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <assert.h>
+
+#include "skiplist.h"
+#include "workload.h"
+
+#define MAGIQUE "SKWL"
+#define VERSION 1
+#define TAILLE_ENTETE 48
+#define TAILLE_ENREGISTREMENT 5
+// Paramètre de la loi de Zipf
+#define THETA 0.99
+// Taille des séries triées de DISTRIBUTION_SORTED
+#define TAILLE_SERIE 1024
+// Nombre de dernières valeurs visées par DISTRIBUTION_SEQUENTIAL
+#define FENETRE 1024
+
+const char *noms_operations[WORKLOAD_NB_OPERATIONS] = {"insert", "search", "remove", "ith", "range"};
+const char *noms_distributions[WORKLOAD_NB_DISTRIBUTIONS] = {"uniform", "zipf", "sequential", "sorted", "adversarial"};
+
+typedef struct s_generateur {
+    const WorkloadParameters* p;
+    unsigned long long etat;    // État du générateur pseudo-aléatoire
+    unsigned int poids_total;   // Somme des poids des opérations
+    double zetan;               // Constantes de la loi de Zipf
+    double alpha;
+    double eta;
+    int* serie;                 // Série triée courante
+    unsigned int position;      // Position dans la série triée
+    unsigned int compteur;      // Nombre de valeurs produites
+    unsigned int dernier;       // Prochaine valeur insérée en séquentiel
+} Generateur;
+
+const char *workload_operation_name(WorkloadOperation op) {
+    assert(op < WORKLOAD_NB_OPERATIONS);
+    return noms_operations[op];
+}
+
+const char *workload_distribution_name(WorkloadDistribution dist) {
+    assert(dist < WORKLOAD_NB_DISTRIBUTIONS);
+    return noms_distributions[dist];
+}
+
+WorkloadDistribution workload_distribution_from_name(const char *name) {
+    unsigned int i = 0;
+    while (i < WORKLOAD_NB_DISTRIBUTIONS && strcmp(name, noms_distributions[i]) != 0)
+        i++;
+    return (WorkloadDistribution)i;
+}
+
+void workload_default_parameters(WorkloadParameters *p) {
+    p->seed = 0;
+    p->nb_operations = 1000000;
+    p->nb_prefill = 100000;
+    p->keyspace = 2000000;
+    p->nb_levels = 16;
+    p->range_width = 100;
+    p->distribution = DISTRIBUTION_UNIFORM;
+    p->mix[WORKLOAD_INSERT] = 30;
+    p->mix[WORKLOAD_SEARCH] = 60;
+    p->mix[WORKLOAD_REMOVE] = 10;
+    p->mix[WORKLOAD_ITH] = 0;
+    p->mix[WORKLOAD_RANGE] = 0;
+}
+
+/*-----------------------*/
+/* Génération            */
+/*-----------------------*/
+
+/**
+ * \brief Tire un nombre pseudo-aléatoire de 64 bits (splitmix64)
+ * \param etat L'état du générateur, mis à jour
+ * \return Le nombre tiré
+ */
+unsigned long long tirer(unsigned long long* etat) {
+    unsigned long long z = (*etat += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * \brief Tire uniformément un entier dans [0, n[
+ */
+unsigned int tirer_borne(Generateur* g, unsigned int n) {
+    return (unsigned int)(((tirer(&g->etat) >> 32) * n) >> 32);
+}
+
+/**
+ * \brief Tire uniformément un réel dans [0, 1[
+ */
+double tirer_reel(Generateur* g) {
+    return (double)(tirer(&g->etat) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * \brief Tire un rang dans [0, keyspace[ suivant la loi de Zipf (algorithme de Gray et al.)
+ * puis le disperse dans l'espace des valeurs
+ */
+unsigned int tirer_zipf(Generateur* g) {
+    unsigned int n = g->p->keyspace;
+    double u = tirer_reel(g);
+    double uz = u * g->zetan;
+    unsigned long long rang;
+    if (uz < 1.0)
+        rang = 0;
+    else if (uz < 1.0 + pow(0.5, THETA))
+        rang = 1;
+    else
+        rang = (unsigned long long)(n * pow(g->eta * u - g->eta + 1.0, g->alpha));
+    if (rang >= n)
+        rang = n - 1;
+    // Les valeurs populaires ne sont pas toutes les plus petites
+    return (unsigned int)(((rang * 0x9E3779B97F4A7C15ULL) >> 16) % n);
+}
+
+int comparer_entiers(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+void initialiser_generateur(Generateur* g, const WorkloadParameters* p) {
+    g->p = p;
+    g->etat = p->seed;
+    g->poids_total = 0;
+    for (unsigned int i = 0; i < WORKLOAD_NB_OPERATIONS; i++)
+        g->poids_total += p->mix[i];
+    g->serie = NULL;
+    g->position = TAILLE_SERIE;
+    g->compteur = 0;
+    g->dernier = 0;
+    if (p->distribution == DISTRIBUTION_ZIPF) {
+        double zeta2 = 1.0 + pow(0.5, THETA);
+        g->zetan = 0.0;
+        for (unsigned int i = 1; i <= p->keyspace; i++)
+            g->zetan += 1.0 / pow((double)i, THETA);
+        g->alpha = 1.0 / (1.0 - THETA);
+        g->eta = (1.0 - pow(2.0 / p->keyspace, 1.0 - THETA)) / (1.0 - zeta2 / g->zetan);
+    }
+    if (p->distribution == DISTRIBUTION_SORTED) {
+        g->serie = (int*)malloc(sizeof(int)*TAILLE_SERIE);
+        assert(g->serie != NULL);
+    }
+}
+
+/**
+ * \brief Produit la valeur de la prochaine opération
+ * \param g Le générateur
+ * \param op L'opération à laquelle la valeur est destinée
+ * \param distribution La loi suivie par la valeur
+ * \return La valeur, dans [0, keyspace[
+ */
+unsigned int produire_valeur(Generateur* g, WorkloadOperation op, WorkloadDistribution distribution) {
+    unsigned int n = g->p->keyspace;
+    unsigned int valeur = 0;
+    switch (distribution) {
+        case DISTRIBUTION_UNIFORM :
+            valeur = tirer_borne(g, n);
+            break;
+        case DISTRIBUTION_ZIPF :
+            valeur = tirer_zipf(g);
+            break;
+        case DISTRIBUTION_SEQUENTIAL :
+            if (op == WORKLOAD_INSERT) {
+                valeur = g->dernier;
+                g->dernier = (g->dernier + 1) % n;
+            } else {
+                // Vise une des dernières valeurs insérées
+                unsigned int recul = 1 + tirer_borne(g, FENETRE);
+                valeur = (g->dernier + n - recul % n) % n;
+            }
+            break;
+        case DISTRIBUTION_SORTED :
+            if (g->position == TAILLE_SERIE) {
+                // Prépare la série triée suivante
+                for (unsigned int i = 0; i < TAILLE_SERIE; i++)
+                    g->serie[i] = (int)tirer_borne(g, n);
+                qsort(g->serie, TAILLE_SERIE, sizeof(int), comparer_entiers);
+                g->position = 0;
+            }
+            valeur = (unsigned int)g->serie[g->position++];
+            break;
+        case DISTRIBUTION_ADVERSARIAL :
+            // Alterne entre les deux extrémités de l'espace en se rapprochant du milieu
+            valeur = (g->compteur % 2 == 0) ? (g->compteur / 2) % n : n - 1 - (g->compteur / 2) % n;
+            break;
+        default :
+            assert(false);
+    }
+    g->compteur++;
+    return valeur;
+}
+
+WorkloadOperation produire_operation(Generateur* g) {
+    unsigned int tirage = tirer_borne(g, g->poids_total);
+    unsigned int op = 0;
+    while (tirage >= g->p->mix[op]) {
+        tirage -= g->p->mix[op];
+        op++;
+    }
+    return (WorkloadOperation)op;
+}
+
+void ecrire_entier(unsigned char* tampon, unsigned long long x, unsigned int taille) {
+    for (unsigned int i = 0; i < taille; i++)
+        tampon[i] = (unsigned char)(x >> (8*i));
+}
+
+unsigned long long lire_entier(const unsigned char* tampon, unsigned int taille) {
+    unsigned long long x = 0;
+    for (unsigned int i = 0; i < taille; i++)
+        x |= (unsigned long long)tampon[i] << (8*i);
+    return x;
+}
+
+bool ecrire_operation(FILE* fichier, WorkloadOperation op, unsigned int argument) {
+    unsigned char tampon[TAILLE_ENREGISTREMENT];
+    tampon[0] = (unsigned char)op;
+    ecrire_entier(tampon+1, argument, 4);
+    return fwrite(tampon, TAILLE_ENREGISTREMENT, 1, fichier) == 1;
+}
+
+bool workload_generate(const WorkloadParameters *p, const char *filename) {
+    assert(p->keyspace > 0 && p->keyspace <= INT_MAX);
+    assert(p->nb_levels > 0 && p->nb_levels <= WORKLOAD_MAX_LEVELS);
+    assert(p->range_width > 0);
+    assert(p->distribution < WORKLOAD_NB_DISTRIBUTIONS);
+    FILE* fichier = fopen(filename, "wb");
+    if (fichier == NULL)
+        return false;
+    Generateur g;
+    initialiser_generateur(&g, p);
+    assert(g.poids_total > 0);
+    // Écrit l'entête
+    unsigned char entete[TAILLE_ENTETE];
+    memcpy(entete, MAGIQUE, 4);
+    ecrire_entier(entete+4, VERSION, 4);
+    ecrire_entier(entete+8, p->nb_levels, 4);
+    ecrire_entier(entete+12, p->distribution, 4);
+    ecrire_entier(entete+16, p->keyspace, 4);
+    ecrire_entier(entete+20, p->range_width, 4);
+    ecrire_entier(entete+24, p->seed, 8);
+    ecrire_entier(entete+32, p->nb_prefill, 8);
+    ecrire_entier(entete+40, p->nb_operations, 8);
+    bool ok = fwrite(entete, TAILLE_ENTETE, 1, fichier) == 1;
+    // Le remplissage suit une loi uniforme pour la loi de Zipf, afin que les valeurs populaires ne soient pas toutes présentes
+    WorkloadDistribution remplissage = p->distribution == DISTRIBUTION_ZIPF ? DISTRIBUTION_UNIFORM : p->distribution;
+    for (unsigned int i = 0; ok && i < p->nb_prefill; i++)
+        ok = ecrire_operation(fichier, WORKLOAD_INSERT, produire_valeur(&g, WORKLOAD_INSERT, remplissage));
+    for (unsigned int i = 0; ok && i < p->nb_operations; i++) {
+        WorkloadOperation op = produire_operation(&g);
+        unsigned int argument = produire_valeur(&g, op, p->distribution);
+        if (op == WORKLOAD_ITH)
+            // Le rang est exprimé en proportion de la taille de la liste
+            argument = (unsigned int)(((unsigned long long)argument << 32) / p->keyspace);
+        ok = ecrire_operation(fichier, op, argument);
+    }
+    free(g.serie);
+    if (fclose(fichier) != 0)
+        ok = false;
+    return ok;
+}
+
+/*-----------------------*/
+/* Rejeu                 */
+/*-----------------------*/
+
+unsigned long long maintenant(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ULL + (unsigned long long)t.tv_nsec;
+}
+
+int comparer_durees(const void* a, const void* b) {
+    unsigned long long x = *(const unsigned long long*)a;
+    unsigned long long y = *(const unsigned long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * \brief Calcule les quantiles d'une série de durées
+ * \param durees Les durées, triées par effet de bord
+ * \param nombre Le nombre de durées
+ * \param latences Les quantiles calculés
+ */
+void calculer_latences(unsigned long long* durees, unsigned long long nombre, WorkloadLatencies* latences) {
+    memset(latences, 0, sizeof(WorkloadLatencies));
+    if (nombre == 0)
+        return;
+    qsort(durees, nombre, sizeof(unsigned long long), comparer_durees);
+    latences->p50 = durees[(nombre-1) * 500 / 1000];
+    latences->p90 = durees[(nombre-1) * 900 / 1000];
+    latences->p99 = durees[(nombre-1) * 990 / 1000];
+    latences->p999 = durees[(nombre-1) * 999 / 1000];
+    latences->max = durees[nombre-1];
+}
+
+/**
+ * \brief Exécute une opération sur la liste
+ * \param d La liste
+ * \param op L'opération
+ * \param argument Son argument
+ * \param largeur La largeur des intervalles de WORKLOAD_RANGE
+ * \param resultat Le résultat de l'opération
+ * \return true si l'opération a trouvé ou modifié sa valeur
+ */
+bool executer_operation(SkipList d, WorkloadOperation op, unsigned int argument, unsigned int largeur, long long* resultat) {
+    unsigned int taille = skiplist_size(d);
+    unsigned int nb_operations;
+    *resultat = 0;
+    switch (op) {
+        case WORKLOAD_INSERT :
+            skiplist_insert(d, (int)argument);
+            *resultat = skiplist_size(d) != taille;
+            break;
+        case WORKLOAD_SEARCH :
+            *resultat = skiplist_search(d, (int)argument, &nb_operations);
+            break;
+        case WORKLOAD_REMOVE :
+            skiplist_remove(d, (int)argument);
+            *resultat = skiplist_size(d) != taille;
+            break;
+        case WORKLOAD_ITH :
+            if (taille == 0)
+                return false;
+            *resultat = skiplist_ith(d, (unsigned int)(((unsigned long long)argument * taille) >> 32));
+            return true;
+        case WORKLOAD_RANGE :
+            *resultat = skiplist_range_count(d, (int)argument, argument + largeur - 1 > INT_MAX ? INT_MAX : (int)(argument + largeur - 1));
+            break;
+        default :
+            assert(false);
+    }
+    return *resultat != 0;
+}
+
+bool workload_replay(const char *filename, WorkloadReport *report) {
+    FILE* fichier = fopen(filename, "rb");
+    if (fichier == NULL)
+        return false;
+    // Lit et vérifie l'entête
+    unsigned char entete[TAILLE_ENTETE];
+    if (fread(entete, TAILLE_ENTETE, 1, fichier) != 1 || memcmp(entete, MAGIQUE, 4) != 0
+        || lire_entier(entete+4, 4) != VERSION) {
+        fclose(fichier);
+        return false;
+    }
+    memset(report, 0, sizeof(WorkloadReport));
+    WorkloadParameters* p = &report->parameters;
+    p->nb_levels = (unsigned int)lire_entier(entete+8, 4);
+    p->distribution = (WorkloadDistribution)lire_entier(entete+12, 4);
+    p->keyspace = (unsigned int)lire_entier(entete+16, 4);
+    p->range_width = (unsigned int)lire_entier(entete+20, 4);
+    p->seed = lire_entier(entete+24, 8);
+    unsigned long long nb_prefill = lire_entier(entete+32, 8);
+    unsigned long long nb_operations = lire_entier(entete+40, 8);
+    if (p->nb_levels == 0 || p->nb_levels > WORKLOAD_MAX_LEVELS || p->range_width == 0
+        || p->distribution >= WORKLOAD_NB_DISTRIBUTIONS
+        || nb_prefill > UINT_MAX || nb_operations > UINT_MAX) {
+        fclose(fichier);
+        return false;
+    }
+    p->nb_prefill = (unsigned int)nb_prefill;
+    p->nb_operations = (unsigned int)nb_operations;
+    // Vérifie que le fichier contient exactement les opérations annoncées avant de les allouer
+    unsigned long long nb_total = nb_prefill + nb_operations;
+    long fin = -1;
+    if (fseek(fichier, 0, SEEK_END) == 0)
+        fin = ftell(fichier);
+    if (fin < TAILLE_ENTETE || (unsigned long long)(fin - TAILLE_ENTETE) != TAILLE_ENREGISTREMENT * nb_total
+        || fseek(fichier, TAILLE_ENTETE, SEEK_SET) != 0) {
+        fclose(fichier);
+        return false;
+    }
+    // Charge toutes les opérations avant de les rejouer
+    unsigned char* operations = (unsigned char*)malloc(TAILLE_ENREGISTREMENT * nb_total + 1);
+    assert(operations != NULL);
+    bool ok = fread(operations, TAILLE_ENREGISTREMENT, nb_total, fichier) == nb_total && fgetc(fichier) == EOF;
+    fclose(fichier);
+    for (unsigned long long i = 0; ok && i < nb_total; i++)
+        ok = operations[TAILLE_ENREGISTREMENT*i] < WORKLOAD_NB_OPERATIONS;
+    if (!ok) {
+        free(operations);
+        return false;
+    }
+    // Compte les opérations mesurées de chaque sorte
+    for (unsigned long long i = p->nb_prefill; i < nb_total; i++)
+        report->count[operations[TAILLE_ENREGISTREMENT*i]]++;
+    unsigned long long* durees[WORKLOAD_NB_OPERATIONS];
+    unsigned long long remplies[WORKLOAD_NB_OPERATIONS];
+    for (unsigned int i = 0; i < WORKLOAD_NB_OPERATIONS; i++) {
+        durees[i] = (unsigned long long*)malloc(sizeof(unsigned long long)*(report->count[i] + 1));
+        assert(durees[i] != NULL);
+        remplies[i] = 0;
+    }
+    SkipList d = skiplist_create((int)p->nb_levels);
+    long long resultat;
+    unsigned long long total = 0;
+    for (unsigned long long i = 0; i < nb_total; i++) {
+        WorkloadOperation op = (WorkloadOperation)operations[TAILLE_ENREGISTREMENT*i];
+        unsigned int argument = (unsigned int)lire_entier(operations + TAILLE_ENREGISTREMENT*i + 1, 4);
+        if (i < p->nb_prefill) {
+            executer_operation(d, op, argument, p->range_width, &resultat);
+            continue;
+        }
+        unsigned long long debut = maintenant();
+        bool trouve = executer_operation(d, op, argument, p->range_width, &resultat);
+        unsigned long long duree = maintenant() - debut;
+        durees[op][remplies[op]++] = duree;
+        total += duree;
+        if (trouve)
+            report->hits[op]++;
+        report->checksum = (report->checksum ^ (unsigned long long)resultat) * 0x100000001B3ULL;
+    }
+    report->final_size = skiplist_size(d);
+    report->seconds = total / 1e9;
+    skiplist_delete(d);
+    free(operations);
+    // Calcule les latences de chaque sorte d'opération puis de l'ensemble
+    unsigned long long* toutes = (unsigned long long*)malloc(sizeof(unsigned long long)*(p->nb_operations + 1));
+    assert(toutes != NULL);
+    unsigned long long nb_toutes = 0;
+    for (unsigned int i = 0; i < WORKLOAD_NB_OPERATIONS; i++) {
+        memcpy(toutes + nb_toutes, durees[i], sizeof(unsigned long long)*remplies[i]);
+        nb_toutes += remplies[i];
+        calculer_latences(durees[i], remplies[i], &report->latencies[i]);
+        free(durees[i]);
+    }
+    calculer_latences(toutes, nb_toutes, &report->total);
+    free(toutes);
+    return true;
+}
@@ -0,0 +1,170 @@
+#ifndef __WORKLOAD_H__
+#define __WORKLOAD_H__
+#include <stdbool.h>
+
+
+/**
+ *	@defgroup Workload Reproducible SkipList workloads
+ *  @brief Generation of seeded operation traces and their replay against a SkipList
+ *
+ *	A trace is a binary file made of a header followed by one record per operation.
+ *	All the integers are stored in little endian order so that a trace generated on a machine
+ *	replays identically on any other one.
+ *	@par Header (48 bytes)
+ *	@parblock
+ *	magic "SKWL" (4 bytes), version, number of levels of the list, distribution, key space, range width (4 bytes each),
+ *	seed, number of prefill operations, number of measured operations (8 bytes each).
+ *	@endparblock
+ *	@par Record (5 bytes)
+ *	@parblock
+ *	the operation (1 byte) followed by its argument (4 bytes).
+ *	For WORKLOAD_INSERT, WORKLOAD_SEARCH and WORKLOAD_REMOVE the argument is the value,
+ *	for WORKLOAD_RANGE it is the lower bound of a range of range_width values
+ *	and for WORKLOAD_ITH it is a rank given as a fraction of the size of the list (argument / \f$2^{32}\f$).
+ *	@endparblock
+ *  @{
+ */
+
+/**
+ *	@brief Greatest number of levels of the list a trace may be replayed against.
+ */
+#define WORKLOAD_MAX_LEVELS 64
+
+/**
+ *	@brief The operations that a trace may contain.
+ */
+typedef enum {
+	WORKLOAD_INSERT,	///< skiplist_insert of the argument
+	WORKLOAD_SEARCH,	///< skiplist_search of the argument
+	WORKLOAD_REMOVE,	///< skiplist_remove of the argument
+	WORKLOAD_ITH,		///< skiplist_ith of the rank designed by the argument
+	WORKLOAD_RANGE,		///< skiplist_range_count of [argument, argument + range_width - 1]
+	WORKLOAD_NB_OPERATIONS
+} WorkloadOperation;
+
+/**
+ *	@brief The laws followed by the arguments of the operations.
+ */
+typedef enum {
+	/// values uniformly drawn in the key space
+	DISTRIBUTION_UNIFORM,
+	/// values drawn following a Zipf law of parameter 0.99, the popular values being scattered in the key space
+	DISTRIBUTION_ZIPF,
+	/// insertions of increasing values, the other operations targeting the last inserted values
+	DISTRIBUTION_SEQUENTIAL,
+	/// uniform values delivered by sorted runs of 1024 values
+	DISTRIBUTION_SORTED,
+	/// values alternately taken at both ends of the key space, moving towards its middle
+	DISTRIBUTION_ADVERSARIAL,
+	WORKLOAD_NB_DISTRIBUTIONS
+} WorkloadDistribution;
+
+/**
+ *	@brief Parameters of a generated workload.
+ */
+typedef struct s_WorkloadParameters {
+	/// seed of the generation, two traces generated with the same parameters are identical
+	unsigned long long seed;
+	/// number of measured operations
+	unsigned int nb_operations;
+	/// number of insertions done before the measured operations
+	unsigned int nb_prefill;
+	/// the values are taken in [0, keyspace - 1]
+	unsigned int keyspace;
+	/// number of levels of the replayed SkipList
+	unsigned int nb_levels;
+	/// number of values covered by a WORKLOAD_RANGE operation
+	unsigned int range_width;
+	/// law followed by the values
+	WorkloadDistribution distribution;
+	/// relative weights of each operation in the measured part of the trace
+	unsigned int mix[WORKLOAD_NB_OPERATIONS];
+} WorkloadParameters;
+
+/**
+ *	@brief Latencies, in nanoseconds, of a kind of operation.
+ */
+typedef struct s_WorkloadLatencies {
+	unsigned long long p50;		///< median
+	unsigned long long p90;		///< 90th percentile
+	unsigned long long p99;		///< 99th percentile
+	unsigned long long p999;	///< 99.9th percentile
+	unsigned long long max;		///< slowest operation
+} WorkloadLatencies;
+
+/**
+ *	@brief Results of the replay of a trace.
+ */
+typedef struct s_WorkloadReport {
+	/// header of the replayed trace (the mix is not stored in the trace, see count)
+	WorkloadParameters parameters;
+	/// number of measured operations of each kind
+	unsigned long long count[WORKLOAD_NB_OPERATIONS];
+	/// number of operations of each kind that found (or modified) their value
+	unsigned long long hits[WORKLOAD_NB_OPERATIONS];
+	/// size of the list at the end of the replay
+	unsigned int final_size;
+	/// digest of the results of all the operations, identical for two replays of the same trace
+	unsigned long long checksum;
+	/// cumulated duration of the measured operations, in seconds
+	double seconds;
+	/// latencies of each kind of operation
+	WorkloadLatencies latencies[WORKLOAD_NB_OPERATIONS];
+	/// latencies of all the measured operations
+	WorkloadLatencies total;
+} WorkloadReport;
+
+/**
+ *	@brief Name of an operation.
+ *	@param op the operation
+ *	@return its name, as used in the reports.
+ */
+const char *workload_operation_name(WorkloadOperation op);
+
+/**
+ *	@brief Name of a distribution.
+ *	@param dist the distribution
+ *	@return its name, as accepted by workload_distribution_from_name().
+ */
+const char *workload_distribution_name(WorkloadDistribution dist);
+
+/**
+ *	@brief Distribution designed by a name.
+ *	@param name one of "uniform", "zipf", "sequential", "sorted" or "adversarial"
+ *	@return the distribution, or WORKLOAD_NB_DISTRIBUTIONS if the name is unknown.
+ */
+WorkloadDistribution workload_distribution_from_name(const char *name);
+
+/**
+ *	@brief Default parameters of a workload.
+ *
+ *	One million uniform operations (30% insert, 60% search, 10% remove) on a list of 16 levels
+ *	prefilled with 100000 values taken in [0, 2000000[.
+ *	@param p the parameters to initialize
+ */
+void workload_default_parameters(WorkloadParameters *p);
+
+/**
+ *	@brief Generate a trace.
+ *	@param p the parameters of the workload
+ *	@param filename the file to write the trace into
+ *	@return true if the trace was written, false otherwise (errno describes the error).
+ *	@pre 0 \f$<\f$ p->keyspace \f$\le\f$ INT_MAX, 0 \f$<\f$ p->nb_levels \f$\le\f$ WORKLOAD_MAX_LEVELS,
+ *	0 \f$<\f$ p->range_width and the sum of p->mix is not 0
+ */
+bool workload_generate(const WorkloadParameters *p, const char *filename);
+
+/**
+ *	@brief Replay a trace against a new SkipList.
+ *
+ *	The whole trace is loaded before the replay. The prefill operations are not measured.
+ *	Each measured operation is timed individually, so the latencies include the cost of reading the clock.
+ *	@param filename the file containing the trace
+ *	@param report the results of the replay
+ *	@return true if the trace was replayed, false if it could not be read or is not a valid trace.
+ */
+bool workload_replay(const char *filename, WorkloadReport *report);
+
+/** @} */
+
+#endif